@@ -29,18 +29,49 @@
 extern "C" {
 #endif
 
+/* Timing wheel geometry: MULTITIMER_WHEEL_LEVELS levels of 2^MULTITIMER_WHEEL_BITS slots.
+ * The default 5 x 32 slots covers 2^25 ticks (~9.3 h at 1 ms); longer timers park in an overflow list. */
+#ifndef MULTITIMER_WHEEL_BITS
+#define MULTITIMER_WHEEL_BITS 5
+#endif
+#ifndef MULTITIMER_WHEEL_LEVELS
+#define MULTITIMER_WHEEL_LEVELS 5
+#endif
+
+/* Per-timer runtime statistics (invocations, execution cycles, dispatch lateness). */
+#ifndef MULTITIMER_ENABLE_STATS
+#define MULTITIMER_ENABLE_STATS 1
+#endif
+
 typedef uint64_t (*PlatformTicksFunction_t)(void);
+typedef uint32_t (*PlatformCyclesFunction_t)(void);
 
 typedef struct MultiTimerHandle MultiTimer;
 
 typedef void (*MultiTimerCallback_t)(MultiTimer* timer, void* userData);
 
+typedef struct
+{
+    uint32_t invocations;   // Callback invocations
+    uint32_t maxCycles;     // Longest single callback, in cycles
+    uint64_t totalCycles;   // Sum of all callback execution times, in cycles
+    uint32_t maxLateness;   // Worst delay between deadline and dispatch, in ticks
+} MultiTimerStats;
+
+/* Handles must start zero-initialised (static storage or memset) so that pprev reads as "not linked". */
 struct MultiTimerHandle
 {
     MultiTimer*          next;
+    MultiTimer**         pprev;
     uint64_t             deadline;
+    uint64_t             period;    // 0: one-shot, otherwise re-armed from the previous deadline
+    uint32_t             overrun;   // Periods skipped right before the current callback
+    uint32_t             missed;    // Total periods skipped since multiTimerStartPeriodic
     MultiTimerCallback_t callback;
     void*                userData;
+#if MULTITIMER_ENABLE_STATS
+    MultiTimerStats      stats;
+#endif
 };
 
 /**
@@ -52,7 +83,39 @@ struct MultiTimerHandle
 int multiTimerInstall(PlatformTicksFunction_t ticksFunc);
 
 /**
- * @brief Start the timer work, add the handle into work list.
+ * @brief Platform cycle counter used to time callbacks when MULTITIMER_ENABLE_STATS is set.
+ *
+ * @param cyclesFunc free-running 32-bit cycle counter (e.g. DWT->CYCCNT), NULL disables timing.
+ * @return int 0 on success.
+ */
+int multiTimerInstallCycles(PlatformCyclesFunction_t cyclesFunc);
+
+#if MULTITIMER_ENABLE_STATS
+/* Register view of the statistics, MULTITIMER_STATS_REGISTERS 16-bit words per timer, 32-bit fields high word first:
+ * +0/+1 invocations, +2/+3 total run time (ms), +4/+5 longest run (us), +6 max lateness (ticks), +7 missed periods. */
+#define MULTITIMER_STATS_REGISTERS 8
+
+/**
+ * @brief Select the timers exposed through multiTimerStatsRegister.
+ *
+ * @param timers table of timer handles, must stay valid (static storage).
+ * @param count number of entries in the table.
+ * @param cyclesPerMs cycle counter rate used to convert run times, e.g. SystemCoreClock / 1000.
+ * @return int 0 on success, -1 on error.
+ */
+int multiTimerStatsTable(MultiTimer* const* timers, uint16_t count, uint32_t cyclesPerMs);
+
+/**
+ * @brief Read one word of the register view.
+ *
+ * @param offset timer index * MULTITIMER_STATS_REGISTERS + field.
+ * @return uint16_t the word, 0 past the end of the table.
+ */
+uint16_t multiTimerStatsRegister(uint16_t offset);
+#endif
+
+/**
+ * @brief Start the timer work, add the handle into the timing wheel. O(1).
  *
  * @param timer target handle strcut.
  * @param timing Set the start time.
@@ -63,7 +126,27 @@ int multiTimerInstall(PlatformTicksFunction_t ticksFunc);
 int multiTimerStart(MultiTimer* timer, uint64_t timing, MultiTimerCallback_t callback, void* userData);
 
 /**
- * @brief Stop the timer work, remove the handle off work list.
+ * @brief Start a periodic timer, the first deadline is one period from now.
+ *
+ * Every deadline is the previous deadline plus the period, so callback run time and late dispatch do not
+ * accumulate as drift. The timer is re-armed before its callback runs; the callback may stop it or restart
+ * it as a one-shot.
+ *
+ * Overrun policy: a dispatch that is late by less than one period runs normally. When it is late by n >= 1
+ * whole periods, the n missed invocations are skipped rather than replayed back to back: the callback runs
+ * once, timer->overrun is set to n, timer->missed accumulates n, and the timer stays on its original phase.
+ * Callbacks that count time (e.g. a seconds countdown) should consume 1 + timer->overrun periods.
+ *
+ * @param timer target handle strcut.
+ * @param period Period in ticks, must be non-zero.
+ * @param callback deadline callback.
+ * @param userData user data.
+ * @return int 0: success, -1: fail.
+ */
+int multiTimerStartPeriodic(MultiTimer* timer, uint64_t period, MultiTimerCallback_t callback, void* userData);
+
+/**
+ * @brief Stop the timer work, remove the handle off the timing wheel. O(1).
  *
  * @param timer target handle strcut.
  * @return int 0: success, -1: fail.
@@ -73,7 +156,7 @@ int multiTimerStop(MultiTimer* timer);
 /**
  * @brief Check the timer expried and call callback.
  *
- * @return int The next timer expires.
+ * @return int Ticks until the next timer expires (a lower bound), 0 if no timer is pending.
  */
 int multiTimerYield(void);
 
@@ -44,18 +44,26 @@ extern "C" {
 
 /* Exported constants --------------------------------------------------------*/
 /* USER CODE BEGIN EC */
-
+// 1：向量表、TIM3/SysTick 中断与Flash擦写例程在SRAM中运行，擦写Flash期间节拍不停；须使用 LUNAR_ramfunc.sct 链接
+#ifndef RAMFUNC_ENABLE
+#define RAMFUNC_ENABLE 0
+#endif
 /* USER CODE END EC */
 
 /* Exported macro ------------------------------------------------------------*/
 /* USER CODE BEGIN EM */
-
+#if RAMFUNC_ENABLE
+#define RAMFUNC __attribute__((section("RAMCODE")))   // 放入 RAMCODE 段，由分散加载文件搬到SRAM执行
+#else
+#define RAMFUNC
+#endif
 /* USER CODE END EM */
 
 /* Exported functions prototypes ---------------------------------------------*/
 void Error_Handler(void);
 
 /* USER CODE BEGIN EFP */
+void SystemClock_Config(void);
 
 /* USER CODE END EFP */
 
@@ -59,12 +59,14 @@ void DMA1_Channel1_IRQHandler(void);
 void DMA1_Channel2_IRQHandler(void);
 void DMA1_Channel3_IRQHandler(void);
 void DMA1_Channel6_IRQHandler(void);
-void DMA1_Channel7_IRQHandler(void);
-void TIM2_IRQHandler(void);
 void TIM3_IRQHandler(void);
 void USART2_IRQHandler(void);
 void USART3_IRQHandler(void);
 /* USER CODE BEGIN EFP */
+void RTC_Alarm_IRQHandler(void);
+#if RAMFUNC_ENABLE
+void vector_table_relocate(void);
+#endif
 
 /* USER CODE END EFP */
 
@@ -1,26 +1,207 @@
 #include "MultiTimer.h"
 #include <stdio.h>
 
-static MultiTimer* timerList = NULL;
+/*
+ * Hierarchical timing wheel.
+ *
+ * Level 0 holds timers that expire within the current rotation of WHEEL_SIZE ticks, one slot per tick.
+ * Level n holds timers that share every bit above level n with wheelTick, one slot per 2^(n*WHEEL_BITS)
+ * ticks. Whenever level 0 wraps, the due slot of the next level is cascaded down, so start, stop and
+ * expiry are all O(1) regardless of how many timers are registered.
+ */
+#define WHEEL_BITS MULTITIMER_WHEEL_BITS
+#define WHEEL_LEVELS MULTITIMER_WHEEL_LEVELS
+#define WHEEL_SIZE (1u << WHEEL_BITS)
+#define WHEEL_MASK (WHEEL_SIZE - 1u)
+#define WHEEL_SPAN_BITS (WHEEL_BITS * WHEEL_LEVELS)
+
+#if WHEEL_BITS > 5
+#error "MULTITIMER_WHEEL_BITS must be <= 5, slot occupancy is tracked in a 32-bit bitmap"
+#endif
+
+static MultiTimer* wheelSlot[WHEEL_LEVELS][WHEEL_SIZE];
+static uint32_t wheelBitmap[WHEEL_LEVELS];   // bit n set <=> wheelSlot[level][n] is not empty
+static MultiTimer* overflowList = NULL;      // Timers beyond the span of the wheel
+static uint64_t wheelTick = 0;               // Next tick to process, every tick before it has expired
 static PlatformTicksFunction_t platformTicksFunction = NULL;
+static PlatformCyclesFunction_t platformCyclesFunction = NULL;
+#if MULTITIMER_ENABLE_STATS
+static MultiTimer* const* statsTable = NULL; // Timers exposed through multiTimerStatsRegister
+static uint16_t statsCount = 0;
+static uint32_t statsCyclesPerMs = 1;
+#endif
+
+static uint32_t lowestBit(uint32_t value) {
+    static const uint8_t debruijn[32] = {0,  1,  28, 2,  29, 14, 24, 3, 30, 22, 20, 15, 25, 17, 4,  8,
+                                         31, 27, 13, 23, 21, 19, 16, 7, 26, 12, 18, 6,  11, 5,  10, 9};
+    return debruijn[((value & (~value + 1u)) * 0x077CB531u) >> 27];
+}
+
+static int wheelEmpty(void) {
+    for (int level = 0; level < WHEEL_LEVELS; level++) {
+        if (wheelBitmap[level]) {
+            return 0;
+        }
+    }
+    return overflowList == NULL;
+}
+
+static void linkTimer(MultiTimer** head, MultiTimer* timer) {
+    timer->next = *head;
+    if (*head) {
+        (*head)->pprev = &timer->next;
+    }
+    timer->pprev = head;
+    *head = timer;
+}
+
+static void removeTimer(MultiTimer* timer) {
+    MultiTimer** pprev = timer->pprev;
+    if (pprev == NULL) {
+        return; // Not linked
+    }
+    *pprev = timer->next;
+    if (timer->next) {
+        timer->next->pprev = pprev;
+    }
+    timer->next = NULL;
+    timer->pprev = NULL;
+
+    // Clear the occupancy bit when the timer was the last one in its wheel slot
+    if (*pprev == NULL && pprev >= &wheelSlot[0][0] && pprev < &wheelSlot[0][0] + WHEEL_LEVELS * WHEEL_SIZE) {
+        uint32_t index = (uint32_t)(pprev - &wheelSlot[0][0]);
+        wheelBitmap[index >> WHEEL_BITS] &= ~(1u << (index & WHEEL_MASK));
+    }
+}
+
+static void placeTimer(MultiTimer* timer) {
+    uint64_t expires = (timer->deadline < wheelTick) ? wheelTick : timer->deadline;
+
+    for (int level = 0; level < WHEEL_LEVELS; level++) {
+        unsigned shift = (unsigned)(level + 1) * WHEEL_BITS;
+        if ((expires >> shift) == (wheelTick >> shift)) {
+            uint32_t slot = (uint32_t)(expires >> (level * WHEEL_BITS)) & WHEEL_MASK;
+            linkTimer(&wheelSlot[level][slot], timer);
+            wheelBitmap[level] |= 1u << slot;
+            return;
+        }
+    }
+    linkTimer(&overflowList, timer);
+}
+
+static void replaceList(MultiTimer** head) {
+    MultiTimer* list = *head;
+    *head = NULL;
+    while (list) {
+        MultiTimer* next = list->next;
+        placeTimer(list);
+        list = next;
+    }
+}
+
+// Called when wheelTick enters a new level-0 rotation: move the due slots of upper levels down.
+static void cascadeTimers(void) {
+    int top = 1;
+    while (top + 1 < WHEEL_LEVELS && ((wheelTick >> (top * WHEEL_BITS)) & WHEEL_MASK) == 0) {
+        top++;
+    }
+    if ((wheelTick & (((uint64_t)1 << WHEEL_SPAN_BITS) - 1)) == 0) {
+        replaceList(&overflowList);
+    }
+    for (int level = top; level >= 1; level--) {
+        uint32_t slot = (uint32_t)(wheelTick >> (level * WHEEL_BITS)) & WHEEL_MASK;
+        wheelBitmap[level] &= ~(1u << slot);
+        replaceList(&wheelSlot[level][slot]);
+    }
+}
+
+static void advanceWheel(uint64_t tick) {
+    wheelTick = tick;
+    if ((tick & WHEEL_MASK) == 0) {
+        cascadeTimers(); // Cascade as soon as a rotation starts so level 0 always holds the earliest timers
+    }
+}
 
 int multiTimerInstall(PlatformTicksFunction_t ticksFunc) {
     if (ticksFunc == NULL) {
         return -1; // Indicate error if ticksFunc is NULL
     }
     platformTicksFunction = ticksFunc;
+    if (wheelEmpty()) {
+        advanceWheel(ticksFunc()); // Align the wheel with the platform clock
+    }
     return 0;
 }
 
-static void removeTimer(MultiTimer* timer) {
-    MultiTimer** current = &timerList;
-    while (*current) {
-        if (*current == timer) {
-            *current = timer->next;
-            break;
+int multiTimerInstallCycles(PlatformCyclesFunction_t cyclesFunc) {
+    platformCyclesFunction = cyclesFunc;
+    return 0;
+}
+
+#if MULTITIMER_ENABLE_STATS
+static void recordStats(MultiTimerStats* stats, uint64_t lateness, uint32_t startCycles) {
+    uint32_t cycles = platformCyclesFunction ? platformCyclesFunction() - startCycles : 0;
+
+    stats->invocations++;
+    stats->totalCycles += cycles;
+    if (cycles > stats->maxCycles) {
+        stats->maxCycles = cycles;
+    }
+    if (lateness > stats->maxLateness) {
+        stats->maxLateness = (lateness > UINT32_MAX) ? UINT32_MAX : (uint32_t)lateness;
+    }
+}
+
+int multiTimerStatsTable(MultiTimer* const* timers, uint16_t count, uint32_t cyclesPerMs) {
+    if ((count && !timers) || cyclesPerMs == 0) {
+        return -1;
+    }
+    statsTable = timers;
+    statsCount = count;
+    statsCyclesPerMs = cyclesPerMs;
+    return 0;
+}
+
+uint16_t multiTimerStatsRegister(uint16_t offset) {
+    uint16_t index = offset / MULTITIMER_STATS_REGISTERS;
+    uint16_t field = offset % MULTITIMER_STATS_REGISTERS;
+    if (index >= statsCount) {
+        return 0;
+    }
+
+    const MultiTimer* timer = statsTable[index];
+    uint32_t value;
+    switch (field / 2) {
+        case 0: value = timer->stats.invocations; break;
+        case 1: value = (uint32_t)(timer->stats.totalCycles / statsCyclesPerMs); break;
+        case 2: value = (uint32_t)((uint64_t)timer->stats.maxCycles * 1000 / statsCyclesPerMs); break;
+        default:
+            value = (field == 6) ? timer->stats.maxLateness : timer->missed;
+            return (value > 0xFFFF) ? 0xFFFF : (uint16_t)value; // Single-word fields saturate
+    }
+    return (field & 1) ? (uint16_t)value : (uint16_t)(value >> 16); // High word first
+}
+#endif
+
+// Earliest tick at which the wheel has work to do: exact for level 0, the cascade point for upper levels.
+static int nextEventTick(uint64_t* tick) {
+    if (wheelBitmap[0]) {
+        *tick = (wheelTick & ~(uint64_t)WHEEL_MASK) | lowestBit(wheelBitmap[0]);
+        return 1;
+    }
+    for (int level = 1; level < WHEEL_LEVELS; level++) {
+        if (wheelBitmap[level]) {
+            unsigned shift = (unsigned)level * WHEEL_BITS;
+            uint64_t epoch = (wheelTick >> (shift + WHEEL_BITS)) << (shift + WHEEL_BITS);
+            *tick = epoch | ((uint64_t)lowestBit(wheelBitmap[level]) << shift);
+            return 1;
         }
-        current = &(*current)->next;
     }
+    if (overflowList) {
+        *tick = ((wheelTick >> WHEEL_SPAN_BITS) + 1) << WHEEL_SPAN_BITS;
+        return 1;
+    }
+    return 0;
 }
 
 int multiTimerStart(MultiTimer* timer, uint64_t timing, MultiTimerCallback_t callback, void* userData) {
@@ -31,20 +212,40 @@ int multiTimerStart(MultiTimer* timer, uint64_t timing, MultiTimerCallback_t cal
     removeTimer(timer); // Centralize removal logic
 
     timer->deadline = platformTicksFunction() + timing;
+    timer->period = 0;
     timer->callback = callback;
     timer->userData = userData;
 
-    MultiTimer** current = &timerList;
-    while (*current && ((*current)->deadline < timer->deadline)) {
-        current = &(*current)->next;
-    }
-    timer->next = *current;
-    *current = timer;
+    placeTimer(timer);
 
     return 0;
 }
 
+int multiTimerStartPeriodic(MultiTimer* timer, uint64_t period, MultiTimerCallback_t callback, void* userData) {
+    if (period == 0 || multiTimerStart(timer, period, callback, userData) != 0) {
+        return -1;
+    }
+    timer->period = period;
+    timer->overrun = 0;
+    timer->missed = 0;
+    return 0;
+}
+
+// Re-arm a periodic timer from its previous deadline, skipping whole periods it is already late for.
+static void rearmPeriodic(MultiTimer* timer, uint64_t currentTicks) {
+    uint64_t late = (currentTicks > timer->deadline) ? currentTicks - timer->deadline : 0;
+    uint64_t skipped = (late >= timer->period) ? late / timer->period : 0;
+
+    timer->overrun = (uint32_t)skipped;
+    timer->missed += (uint32_t)skipped;
+    timer->deadline += (skipped + 1) * timer->period;
+    placeTimer(timer);
+}
+
 int multiTimerStop(MultiTimer* timer) {
+    if (!timer) {
+        return -1;
+    }
     removeTimer(timer); // Use centralized removal function
     return 0;
 }
@@ -54,13 +255,48 @@ int multiTimerYield(void) {
         return -1; // Indicate error if platformTicksFunction is NULL
     }
     uint64_t currentTicks = platformTicksFunction();
-    while (timerList && (currentTicks >= timerList->deadline)) {
-        MultiTimer* timer = timerList;
-        timerList = timer->next; // Remove expired timer
+    while (wheelTick <= currentTicks) {
+        uint32_t index = (uint32_t)wheelTick & WHEEL_MASK;
+
+        // Skip empty slots: jump to the next occupied slot or to the next rotation
+        uint64_t target = wheelBitmap[0] ? ((wheelTick & ~(uint64_t)WHEEL_MASK) | lowestBit(wheelBitmap[0]))
+                                         : ((wheelTick | WHEEL_MASK) + 1);
+        if (target != wheelTick) {
+            advanceWheel((target <= currentTicks) ? target : currentTicks + 1);
+            continue;
+        }
 
-        if (timer->callback) {
-            timer->callback(timer, timer->userData); // Execute callback
+        // Detach the due slot so callbacks may freely restart or stop any timer
+        MultiTimer* expired = wheelSlot[0][index];
+        wheelSlot[0][index] = NULL;
+        wheelBitmap[0] &= ~(1u << index);
+        expired->pprev = &expired;
+        advanceWheel(wheelTick + 1);
+
+        while (expired) {
+            MultiTimer* timer = expired;
+            uint64_t dueTick = timer->deadline;
+            removeTimer(timer); // Remove expired timer
+            if (timer->period) {
+                rearmPeriodic(timer, currentTicks);
+            }
+
+            if (timer->callback) {
+#if MULTITIMER_ENABLE_STATS
+                uint64_t dispatchTick = platformTicksFunction();
+                uint32_t startCycles = platformCyclesFunction ? platformCyclesFunction() : 0;
+                timer->callback(timer, timer->userData); // Execute callback
+                recordStats(&timer->stats, dispatchTick > dueTick ? dispatchTick - dueTick : 0, startCycles);
+#else
+                timer->callback(timer, timer->userData); // Execute callback
+#endif
+            }
         }
     }
-    return timerList ? (int)(timerList->deadline - currentTicks) : 0;
+
+    uint64_t nextTick;
+    if (!nextEventTick(&nextTick)) {
+        return 0;
+    }
+    return (nextTick > currentTicks) ? (int)(nextTick - currentTicks) : 0;
 }
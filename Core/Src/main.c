@@ -29,17 +29,22 @@
 /* USER CODE BEGIN Includes */
 #include "MultiTimer.h"
 #include "alarm.h"
+#include "at_cmd.h"
 #include "beep.h"
+#include "boot.h"
 #include "bt401.h"
 #include "hardware_register.h"
 #include "key.h"
+#include "kv_store.h"
 #include "led.h"
+#include "lowpower.h"
 #include "mytime.h"
 #include "ntc.h"
 #include "pid.h"
 #include "protocol.h"
 #include "register_interface.h"
 #include "shortcut.h"
+#include "stm32f1xx_it.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -92,93 +97,104 @@ uint64_t getPlatformTicks(void)
 {
     return platform_ticks;   // 返回平台滴答计数器
 }
+uint32_t getPlatformCycles(void)
+{
+    return DWT->CYCCNT;   // 返回DWT周期计数器，用于统计任务执行时间
+}
 void protocol_task_callback(MultiTimer* timer, void* arg)
 {
     // 协议轮询函数
     protocol_poll();
-    multiTimerStart(&protocolTimer, 100, protocol_task_callback, NULL);
+    report_poll();   // 寄存器变化通知
 }
 void alarm_task_callback(MultiTimer* timer, void* arg)
 {
     // 闹钟轮询函数
     alarm_poll();
-    multiTimerStart(&alarmTimer, 1000, alarm_task_callback, NULL);
 }
 void key_task_callback(MultiTimer* timer, void* arg)
 {
     // 按键扫描函数
     key_scan();
-    multiTimerStart(&keyTimer, 20, key_task_callback, NULL);
 }
 void ntc_task_callback(MultiTimer* timer, void* arg)
 {
     // NTC 控温函数
     NTC_control(1000);
-    multiTimerStart(&ntcTimer, 1000, ntc_task_callback, NULL);
 }
 void update_task_callback(MultiTimer* timer, void* arg)
 {
     led_update_states();
     beep_update();
-    multiTimerStart(&updateTimer, 1, update_task_callback, NULL);   // 每1ms刷新
 }
 void countdown_task_callback(MultiTimer* timer, void* arg)
 {
     // 倒计时更新函数
-    countdown_update(1);
-    multiTimerStart(&countdownTimer, 1000, countdown_task_callback, NULL);   // 每1000ms更新倒计时
+    countdown_update(1 + timer->overrun);   // 补偿调度延迟跳过的周期
 }
 void upload_task_callback(MultiTimer* timer, void* arg)
 {
     // 上传数据函数
     upload_reg_value();
-    multiTimerStart(&uploadTimer, 2000, upload_task_callback, NULL);   // 每3000ms上传数据
 }
 void ring_task_callback(MultiTimer* timer, void* arg)
 {
     // 铃声任务回调函数
     ring_Gradually_increase();
-    multiTimerStart(&ringTimer, 500, ring_task_callback, NULL);
 }
 void night_task_callback(MultiTimer* timer, void* arg)
 {
     // 夜间模式任务回调函数
     // Intelligent_temperature_control();
-    multiTimerStart(&nightTimer, 60000, night_task_callback, NULL);
 }
 void query_task_callback(MultiTimer* timer, void* arg)
 {
     // print_current_datetime();   // 打印当前时间
     // 查询任务回调函数
     update_bt_led();
-    multiTimerStart(&queryTimer, 1000, query_task_callback, NULL);   // 每1000ms查询BLE状态
 }
+// 任务表，顺序即任务统计寄存器的编号顺序
+static MultiTimer* const task_timers[REG_TASK_STATS_TASKS] = {
+    &updateTimer, &keyTimer,   &protocolTimer,  &ntcTimer,    &ringTimer,
+    &queryTimer,  &alarmTimer, &countdownTimer, &uploadTimer, &nightTimer,
+};
 void task_init(void)
 {
-    multiTimerStart(&updateTimer, 1, update_task_callback, NULL);            // 每1ms刷新
-    multiTimerStart(&keyTimer, 20, key_task_callback, NULL);                 // 每20ms扫描按键
-    multiTimerStart(&protocolTimer, 100, protocol_task_callback, NULL);      // 每100ms轮询协议
-    multiTimerStart(&ntcTimer, 1000, ntc_task_callback, NULL);               // 每1000ms控温
-    multiTimerStart(&ringTimer, 500, ring_task_callback, NULL);              // 每500ms轮询铃声
-    multiTimerStart(&queryTimer, 1000, query_task_callback, NULL);           // 每1000ms查询BLE状态
-    multiTimerStart(&alarmTimer, 1000, alarm_task_callback, NULL);           // 每1000ms轮询闹钟
-    multiTimerStart(&countdownTimer, 1000, countdown_task_callback, NULL);   // 每1000ms更新倒计时
-    multiTimerStart(&uploadTimer, 2000, upload_task_callback, NULL);         // 每3000ms上传数据
-    multiTimerStart(&nightTimer, 60000, night_task_callback, NULL);          // 每60000ms更新夜间模式
+    multiTimerStartPeriodic(&updateTimer, 1, update_task_callback, NULL);              // 每1ms刷新
+    multiTimerStartPeriodic(&keyTimer, 20, key_task_callback, NULL);                   // 每20ms扫描按键
+    multiTimerStartPeriodic(&protocolTimer, 1, protocol_task_callback, NULL);          // 每1ms轮询协议，帧收齐即处理
+    multiTimerStartPeriodic(&ntcTimer, 1000, ntc_task_callback, NULL);                 // 每1000ms控温
+    multiTimerStartPeriodic(&ringTimer, 500, ring_task_callback, NULL);                // 每500ms轮询铃声
+    multiTimerStartPeriodic(&queryTimer, 1000, query_task_callback, NULL);             // 每1000ms查询BLE状态
+    multiTimerStartPeriodic(&alarmTimer, 1000, alarm_task_callback, NULL);             // 每1000ms轮询闹钟
+    multiTimerStartPeriodic(&countdownTimer, 1000, countdown_task_callback, NULL);     // 每1000ms更新倒计时
+    multiTimerStartPeriodic(&uploadTimer, 10000, upload_task_callback, NULL);          // 每10000ms上传数据（保活）
+    multiTimerStartPeriodic(&nightTimer, 60000, night_task_callback, NULL);            // 每60000ms更新夜间模式
+    multiTimerStatsTable(task_timers, REG_TASK_STATS_TASKS, SystemCoreClock / 1000);   // 任务统计寄存器
+}
+// 使能DWT周期计数器
+static void cycle_counter_init(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    multiTimerInstallCycles(getPlatformCycles);
 }
-// 系统初始化
+// 系统初始化：不依赖蓝牙模块的部分，立即完成
 void sys_init(void)
 {
     led_init();
     XX_RTC_Init();
+    kv_init();   // 挂载参数存储区，须在加载闹钟和快捷键之前
     alarm_init();
-    shortcut_init();
+    register_interface_init();   // 一次读取配置记录恢复寄存器（快捷键），加热相关寄存器清零
     Temp_init();
-    HAL_TIM_Base_Start_IT(&htim2);
-    HAL_TIM_Base_Start_IT(&htim3);
-    register_interface_init();   // 初始化寄存器接口
-    HAL_Delay(500);
-    BT401_Init();                                // 初始化蓝牙模块
+    beep_init();                     // 蜂鸣器由TIM2比较事件触发DMA输出，无需中断
+    HAL_TIM_Base_Start_IT(&htim3);   // 平台滴答开始计数，之后的阶段由定时器任务推进
+}
+// 蓝牙模块配置：指令全部异步入队，由AT引擎逐条等待应答
+static void bt_config_start(void)
+{
     send_at_command("AT+BDLUNAR\r\n", 50);       // 设置蓝牙名称
     send_at_command("AT+BMLUNAR_BLE\r\n", 50);   // 设置ble名称
     send_at_command("AT+CG01\r\n", 50);          // 开启 -- 蓝牙跑后台
@@ -193,6 +209,25 @@ void sys_init(void)
     mode_control(BLUETOOTH_MODE);         // 上电直接进入蓝牙模式
 #endif
 }
+static bool bt_config_done(void)
+{
+    return !at_busy();
+}
+// 启动阶段，顺序即启动时间寄存器的编号顺序
+enum
+{
+    BOOT_CORE = 0,    // 参数存储、闹钟、寄存器、控温、蜂鸣器、平台滴答
+    BOOT_TASKS,       // 周期任务启动，按键、LED、控温、闹钟、协议可用
+    BOOT_BT_UART,     // 蓝牙模块上电稳定，启动串口接收
+    BOOT_BT_CONFIG,   // 蓝牙配置指令全部完成
+    BOOT_STAGES
+};
+static const BootStage boot_stages[BOOT_STAGES] = {
+    [BOOT_CORE]      = {0, 0, sys_init, NULL},
+    [BOOT_TASKS]     = {1u << BOOT_CORE, 0, task_init, NULL},
+    [BOOT_BT_UART]   = {1u << BOOT_CORE, 500, BT401_Init, NULL},   // 蓝牙模块上电后约500ms才能响应指令
+    [BOOT_BT_CONFIG] = {1u << BOOT_BT_UART, 0, bt_config_start, bt_config_done},
+};
 int main(void)
 {
 
@@ -206,7 +241,9 @@ int main(void)
     HAL_Init();
 
     /* USER CODE BEGIN Init */
-
+#if RAMFUNC_ENABLE
+    vector_table_relocate();   // 向量表搬到SRAM，擦写Flash期间节拍中断不停顿
+#endif
     /* USER CODE END Init */
 
     /* Configure the system clock */
@@ -230,19 +267,20 @@ int main(void)
     HAL_GPIO_WritePin(POWER_GPIO_Port, POWER_Pin, GPIO_PIN_SET);     // 设置电源引脚为高电平
     HAL_GPIO_WritePin(LED_B_GPIO_Port, LED_B_Pin, GPIO_PIN_RESET);   // Turn on the blue LED
     HAL_Delay(10);                                                   // 延时10ms，等待系统稳定
-    sys_init();                                                      // 初始化系统
-    HAL_Delay(10);                                                   // 延时10ms，等待硬件初始化完成
+    multiTimerInstall(getPlatformTicks);                             // 安装平台滴答计数器获取函数，AT引擎依赖定时器
+    cycle_counter_init();                                            // 安装周期计数器，用于任务运行统计
+    boot_start(boot_stages, BOOT_STAGES);                            // 按依赖顺序启动，不等待蓝牙模块
 
     /* USER CODE END 2 */
 
     /* Infinite loop */
     /* USER CODE BEGIN WHILE */
-    multiTimerInstall(getPlatformTicks);   // 安装平台滴答计数器获取函数
-    task_init();
-    HAL_Delay(500);
+    lowpower_init();
     while (1)
     {
-        multiTimerYield();   // 执行多定时器的回调函数
+        uint64_t yield_tick = getPlatformTicks();
+        int ticks_to_next   = multiTimerYield();   // 执行多定时器的回调函数，返回距下一截止时间的滴答数
+        lowpower_idle(yield_tick, ticks_to_next);   // 空闲时休眠直到下一截止时间或中断
         /* USER CODE END WHILE */
 
         /* USER CODE BEGIN 3 */
@@ -317,10 +355,6 @@ void SystemClock_Config(void)
 
 void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef* htim)
 {
-    if (htim->Instance == TIM2)
-    {
-        beep_pwm_update();
-    }
     if (htim->Instance == TIM3)
     {
         platform_ticks++;   // 平台滴答计数器自增
@@ -328,10 +362,9 @@ void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef* htim)
 }
 void update_bt_led(void)
 {
+    uint8_t status = query_ble_status();   // 查询蓝牙状态，不论模式都要查询，连接变化时协议会话随之复位
     if (ble_key_pressed)
     {
-
-        uint8_t status = query_ble_status();   // 查询蓝牙状态
         if (status == 0)
         {
             led_set_mode(LED_BT, LED_MODE_BLINK, 500);
@@ -345,12 +378,12 @@ void update_bt_led(void)
     }
 }
 
-void two_hour_protect(void)
+void two_hour_protect(uint32_t elapsed)
 {
     static uint32_t heat_protect_time = 0;   // 热敷最长使用时间
     if (is_heating_active() && get_remaining_seconds() == 0)
     {
-        heat_protect_time += 1;   // 每次调用增加1s
+        heat_protect_time += elapsed;   // 本次调用经过的秒数，含调度延迟跳过的周期
     } else
     {
         heat_protect_time = 0;   // 如果不在加热状态，重置计时
@@ -363,7 +396,7 @@ void two_hour_protect(void)
 }
 void countdown_update(uint32_t decrement)
 {
-    two_hour_protect();
+    two_hour_protect(decrement);
     uint32_t remaining_seconds = get_remaining_seconds();
     // 更新 LED 时间选择
     uint16_t remaining_minutes = remaining_seconds / 60;
@@ -372,15 +405,17 @@ void countdown_update(uint32_t decrement)
     // 如果剩余时间大于0且加热或音乐任务正在运行
     if (remaining_seconds > 0 && (is_heating_active() || is_music_active()))
     {
-        remaining_seconds -= decrement;
-        if (remaining_seconds < 1) remaining_seconds = 0;
+        uint32_t previous_minutes = remaining_seconds / 60;
+        remaining_seconds         = (remaining_seconds > decrement) ? remaining_seconds - decrement : 0;
 
         set_remaining_seconds(remaining_seconds);
 
-        // 更新寄存器（仅在整分钟或归零时）
-        if ((remaining_seconds % 60 == 0) || (remaining_seconds == 0))
+        // 更新寄存器（仅在跨过整分钟或归零时，decrement 可能大于1）
+        // 写寄存器会经 rf_time 按整分钟重设剩余时间，之后恢复实际秒数
+        if ((remaining_seconds % 60 == 0) || (remaining_seconds / 60 != previous_minutes))
         {
             register_set_value(REG_HEATING_TIMER, remaining_seconds / 60);
+            set_remaining_seconds(remaining_seconds);
         }
 
         // 停止加热与音乐任务
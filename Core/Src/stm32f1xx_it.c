@@ -56,16 +56,15 @@
 
 /* External variables --------------------------------------------------------*/
 extern DMA_HandleTypeDef  hdma_adc1;
-extern TIM_HandleTypeDef  htim2;
 extern TIM_HandleTypeDef  htim3;
 extern DMA_HandleTypeDef  hdma_usart2_rx;
-extern DMA_HandleTypeDef  hdma_usart2_tx;
 extern DMA_HandleTypeDef  hdma_usart3_rx;
 extern DMA_HandleTypeDef  hdma_usart3_tx;
 extern UART_HandleTypeDef huart2;
 extern UART_HandleTypeDef huart3;
 /* USER CODE BEGIN EV */
 extern uint64_t platform_ticks;   // 平台滴答计数器
+extern RTC_HandleTypeDef hrtc;
 /* USER CODE END EV */
 
 /******************************************************************************/
@@ -260,34 +259,6 @@ void DMA1_Channel6_IRQHandler(void)
     /* USER CODE END DMA1_Channel6_IRQn 1 */
 }
 
-/**
- * @brief This function handles DMA1 channel7 global interrupt.
- */
-void DMA1_Channel7_IRQHandler(void)
-{
-    /* USER CODE BEGIN DMA1_Channel7_IRQn 0 */
-
-    /* USER CODE END DMA1_Channel7_IRQn 0 */
-    HAL_DMA_IRQHandler(&hdma_usart2_tx);
-    /* USER CODE BEGIN DMA1_Channel7_IRQn 1 */
-
-    /* USER CODE END DMA1_Channel7_IRQn 1 */
-}
-
-/**
- * @brief This function handles TIM2 global interrupt.
- */
-void TIM2_IRQHandler(void)
-{
-    /* USER CODE BEGIN TIM2_IRQn 0 */
-
-    /* USER CODE END TIM2_IRQn 0 */
-    HAL_TIM_IRQHandler(&htim2);
-    /* USER CODE BEGIN TIM2_IRQn 1 */
-
-    /* USER CODE END TIM2_IRQn 1 */
-}
-
 /**
  * @brief This function handles TIM3 global interrupt.
  */
@@ -331,5 +302,58 @@ void USART3_IRQHandler(void)
 }
 
 /* USER CODE BEGIN 1 */
+/**
+ * @brief This function handles RTC alarm interrupt through EXTI line 17 (STOP mode wakeup).
+ */
+void RTC_Alarm_IRQHandler(void)
+{
+    HAL_RTC_AlarmIRQHandler(&hrtc);
+}
+
+#if RAMFUNC_ENABLE
+#define VECTOR_COUNT (16 + USBWakeUp_IRQn + 1)   // 内核异常16个 + 外设中断43个
+
+// VTOR 要求按表大小向上取整到2的幂对齐，59个表项需256字节对齐
+static uint32_t _RamVectors[VECTOR_COUNT] __attribute__((aligned(256)));
+
+/**
+ * @brief SysTick 中断的SRAM版本，只推进 HAL 节拍，Flash 擦写期间不会停顿
+ */
+RAMFUNC static void SysTick_Handler_RAM(void)
+{
+    uwTick += (uint32_t)uwTickFreq;
+}
+
+/**
+ * @brief TIM3 中断的SRAM版本，只使能了更新中断，直接清标志并推进平台滴答，不经过 HAL_TIM_IRQHandler
+ */
+RAMFUNC static void TIM3_IRQHandler_RAM(void)
+{
+    if (TIM3->SR & TIM_SR_UIF)
+    {
+        TIM3->SR = ~TIM_SR_UIF;
+        platform_ticks++;   // 平台滴答计数器自增
+    }
+}
+
+/**
+ * @brief 把向量表复制到SRAM并切换 VTOR，SysTick 与 TIM3 改由SRAM中的处理函数响应
+ */
+void vector_table_relocate(void)
+{
+    const uint32_t* flash_vectors = (const uint32_t*)SCB->VTOR;
+    for (uint32_t i = 0; i < VECTOR_COUNT; i++)
+    {
+        _RamVectors[i] = flash_vectors[i];
+    }
+    _RamVectors[16 + SysTick_IRQn] = (uint32_t)SysTick_Handler_RAM;
+    _RamVectors[16 + TIM3_IRQn]    = (uint32_t)TIM3_IRQHandler_RAM;
+
+    __disable_irq();
+    SCB->VTOR = (uint32_t)_RamVectors;
+    __DSB();
+    __enable_irq();
+}
+#endif
 
 /* USER CODE END 1 */
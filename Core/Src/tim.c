@@ -27,6 +27,8 @@
 TIM_HandleTypeDef htim1;
 TIM_HandleTypeDef htim2;
 TIM_HandleTypeDef htim3;
+DMA_HandleTypeDef hdma_tim2_ch1;
+DMA_HandleTypeDef hdma_tim2_ch2_ch4;
 
 /* TIM1 init function */
 void MX_TIM1_Init(void)
@@ -96,14 +98,15 @@ void MX_TIM2_Init(void)
 
     TIM_ClockConfigTypeDef  sClockSourceConfig = {0};
     TIM_MasterConfigTypeDef sMasterConfig      = {0};
+    TIM_OC_InitTypeDef      sConfigOC          = {0};
 
     /* USER CODE BEGIN TIM2_Init 1 */
 
     /* USER CODE END TIM2_Init 1 */
     htim2.Instance               = TIM2;
-    htim2.Init.Prescaler         = 32 - 1;
+    htim2.Init.Prescaler         = 320 - 1;
     htim2.Init.CounterMode       = TIM_COUNTERMODE_UP;
-    htim2.Init.Period            = 10 - 1;
+    htim2.Init.Period            = 200 - 1;
     htim2.Init.ClockDivision     = TIM_CLOCKDIVISION_DIV1;
     htim2.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
     if (HAL_TIM_Base_Init(&htim2) != HAL_OK)
@@ -115,12 +118,28 @@ void MX_TIM2_Init(void)
     {
         Error_Handler();
     }
+    if (HAL_TIM_OC_Init(&htim2) != HAL_OK)
+    {
+        Error_Handler();
+    }
     sMasterConfig.MasterOutputTrigger = TIM_TRGO_RESET;
     sMasterConfig.MasterSlaveMode     = TIM_MASTERSLAVEMODE_DISABLE;
     if (HAL_TIMEx_MasterConfigSynchronization(&htim2, &sMasterConfig) != HAL_OK)
     {
         Error_Handler();
     }
+    sConfigOC.OCMode     = TIM_OCMODE_TIMING;
+    sConfigOC.Pulse      = 0;
+    sConfigOC.OCPolarity = TIM_OCPOLARITY_HIGH;
+    sConfigOC.OCFastMode = TIM_OCFAST_DISABLE;
+    if (HAL_TIM_OC_ConfigChannel(&htim2, &sConfigOC, TIM_CHANNEL_1) != HAL_OK)
+    {
+        Error_Handler();
+    }
+    if (HAL_TIM_OC_ConfigChannel(&htim2, &sConfigOC, TIM_CHANNEL_2) != HAL_OK)
+    {
+        Error_Handler();
+    }
     /* USER CODE BEGIN TIM2_Init 2 */
 
     /* USER CODE END TIM2_Init 2 */
@@ -154,7 +173,7 @@ void MX_TIM3_Init(void)
     {
         Error_Handler();
     }
-    sMasterConfig.MasterOutputTrigger = TIM_TRGO_RESET;
+    sMasterConfig.MasterOutputTrigger = TIM_TRGO_UPDATE;
     sMasterConfig.MasterSlaveMode     = TIM_MASTERSLAVEMODE_DISABLE;
     if (HAL_TIMEx_MasterConfigSynchronization(&htim3, &sMasterConfig) != HAL_OK)
     {
@@ -192,9 +211,42 @@ void HAL_TIM_Base_MspInit(TIM_HandleTypeDef* tim_baseHandle)
         /* TIM2 clock enable */
         __HAL_RCC_TIM2_CLK_ENABLE();
 
-        /* TIM2 interrupt Init */
-        HAL_NVIC_SetPriority(TIM2_IRQn, 0, 0);
-        HAL_NVIC_EnableIRQ(TIM2_IRQn);
+        /* TIM2 DMA Init */
+        /* TIM2_CH1 Init */
+        hdma_tim2_ch1.Instance                 = DMA1_Channel5;
+        hdma_tim2_ch1.Init.Direction           = DMA_MEMORY_TO_PERIPH;
+        hdma_tim2_ch1.Init.PeriphInc           = DMA_PINC_DISABLE;
+        hdma_tim2_ch1.Init.MemInc              = DMA_MINC_DISABLE;
+        hdma_tim2_ch1.Init.PeriphDataAlignment = DMA_PDATAALIGN_WORD;
+        hdma_tim2_ch1.Init.MemDataAlignment    = DMA_MDATAALIGN_WORD;
+        hdma_tim2_ch1.Init.Mode                = DMA_CIRCULAR;
+        hdma_tim2_ch1.Init.Priority            = DMA_PRIORITY_LOW;
+        if (HAL_DMA_Init(&hdma_tim2_ch1) != HAL_OK)
+        {
+            Error_Handler();
+        }
+
+        __HAL_LINKDMA(tim_baseHandle, hdma[TIM_DMA_ID_CC1], hdma_tim2_ch1);
+
+        /* TIM2_CH2_CH4 Init */
+        hdma_tim2_ch2_ch4.Instance                 = DMA1_Channel7;
+        hdma_tim2_ch2_ch4.Init.Direction           = DMA_MEMORY_TO_PERIPH;
+        hdma_tim2_ch2_ch4.Init.PeriphInc           = DMA_PINC_DISABLE;
+        hdma_tim2_ch2_ch4.Init.MemInc              = DMA_MINC_DISABLE;
+        hdma_tim2_ch2_ch4.Init.PeriphDataAlignment = DMA_PDATAALIGN_WORD;
+        hdma_tim2_ch2_ch4.Init.MemDataAlignment    = DMA_MDATAALIGN_WORD;
+        hdma_tim2_ch2_ch4.Init.Mode                = DMA_CIRCULAR;
+        hdma_tim2_ch2_ch4.Init.Priority            = DMA_PRIORITY_LOW;
+        if (HAL_DMA_Init(&hdma_tim2_ch2_ch4) != HAL_OK)
+        {
+            Error_Handler();
+        }
+
+        /* Several peripheral DMA handle pointers point to the same DMA handle.
+         Be aware that there is only one channel to perform all the requested DMAs. */
+        __HAL_LINKDMA(tim_baseHandle, hdma[TIM_DMA_ID_CC2], hdma_tim2_ch2_ch4);
+        __HAL_LINKDMA(tim_baseHandle, hdma[TIM_DMA_ID_CC4], hdma_tim2_ch2_ch4);
+
         /* USER CODE BEGIN TIM2_MspInit 1 */
 
         /* USER CODE END TIM2_MspInit 1 */
@@ -267,8 +319,10 @@ void HAL_TIM_Base_MspDeInit(TIM_HandleTypeDef* tim_baseHandle)
         /* Peripheral clock disable */
         __HAL_RCC_TIM2_CLK_DISABLE();
 
-        /* TIM2 interrupt Deinit */
-        HAL_NVIC_DisableIRQ(TIM2_IRQn);
+        /* TIM2 DMA DeInit */
+        HAL_DMA_DeInit(tim_baseHandle->hdma[TIM_DMA_ID_CC1]);
+        HAL_DMA_DeInit(tim_baseHandle->hdma[TIM_DMA_ID_CC2]);
+        HAL_DMA_DeInit(tim_baseHandle->hdma[TIM_DMA_ID_CC4]);
         /* USER CODE BEGIN TIM2_MspDeInit 1 */
 
         /* USER CODE END TIM2_MspDeInit 1 */
@@ -27,7 +27,6 @@ UART_HandleTypeDef huart1;
 UART_HandleTypeDef huart2;
 UART_HandleTypeDef huart3;
 DMA_HandleTypeDef hdma_usart2_rx;
-DMA_HandleTypeDef hdma_usart2_tx;
 DMA_HandleTypeDef hdma_usart3_rx;
 DMA_HandleTypeDef hdma_usart3_tx;
 
@@ -126,21 +125,6 @@ void HAL_UART_MspInit(UART_HandleTypeDef *uartHandle)
 
         __HAL_LINKDMA(uartHandle, hdmarx, hdma_usart2_rx);
 
-        /* USART2_TX Init */
-        hdma_usart2_tx.Instance                 = DMA1_Channel7;
-        hdma_usart2_tx.Init.Direction           = DMA_MEMORY_TO_PERIPH;
-        hdma_usart2_tx.Init.PeriphInc           = DMA_PINC_DISABLE;
-        hdma_usart2_tx.Init.MemInc              = DMA_MINC_ENABLE;
-        hdma_usart2_tx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
-        hdma_usart2_tx.Init.MemDataAlignment    = DMA_MDATAALIGN_BYTE;
-        hdma_usart2_tx.Init.Mode                = DMA_NORMAL;
-        hdma_usart2_tx.Init.Priority            = DMA_PRIORITY_LOW;
-        if (HAL_DMA_Init(&hdma_usart2_tx) != HAL_OK) {
-            Error_Handler();
-        }
-
-        __HAL_LINKDMA(uartHandle, hdmatx, hdma_usart2_tx);
-
         /* USART2 interrupt Init */
         HAL_NVIC_SetPriority(USART2_IRQn, 0, 0);
         HAL_NVIC_EnableIRQ(USART2_IRQn);
@@ -177,7 +161,7 @@ void HAL_UART_MspInit(UART_HandleTypeDef *uartHandle)
         hdma_usart3_rx.Init.MemInc              = DMA_MINC_ENABLE;
         hdma_usart3_rx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
         hdma_usart3_rx.Init.MemDataAlignment    = DMA_MDATAALIGN_BYTE;
-        hdma_usart3_rx.Init.Mode                = DMA_NORMAL;
+        hdma_usart3_rx.Init.Mode                = DMA_CIRCULAR;
         hdma_usart3_rx.Init.Priority            = DMA_PRIORITY_HIGH;
         if (HAL_DMA_Init(&hdma_usart3_rx) != HAL_OK) {
             Error_Handler();
@@ -227,7 +211,6 @@ void HAL_UART_MspDeInit(UART_HandleTypeDef *uartHandle)
 
         /* USART2 DMA DeInit */
         HAL_DMA_DeInit(uartHandle->hdmarx);
-        HAL_DMA_DeInit(uartHandle->hdmatx);
 
         /* USART2 interrupt Deinit */
         HAL_NVIC_DisableIRQ(USART2_IRQn);
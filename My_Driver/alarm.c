@@ -1,12 +1,15 @@
 #include "alarm.h"
+#include "MultiTimer.h"
 #include "beep.h"
 #include "bt401.h"
 #include "flash.h"
 #include "gpio.h"
 #include "hardware_register.h"
 #include "key.h"
+#include "kv_store.h"
 #include "led.h"
 #include "main.h"
+#include "persist.h"
 #include "register_interface.h"
 #include "rtc.h"
 #include "string.h"
@@ -15,6 +18,7 @@
 // 存储多个闹钟的数组
 Alarm_struct alarms[MAX_ALARMS] = {0};
 bool         ring_flag          = 0;
+static MultiTimer ring_play_timer;   // 切换音乐模式后延时播放铃声
 // static uint8_t globa_volume = 10; // 默认音量为10，最大15。
 
 void parse_alarm_data(uint16_t value_H, uint16_t value_L, Alarm_struct* alarm)
@@ -30,6 +34,14 @@ void parse_alarm_data(uint16_t value_H, uint16_t value_L, Alarm_struct* alarm)
     alarm->weekdays    = (value_L >> 2) & 0x7F;   // 2-8 位表示星期标志位
     alarm->ringtone_id = (value_L >> 9) & 0x7F;   // 9-15 位表示铃声ID
 }
+
+// parse_alarm_data 的逆过程，用于回读闹钟表
+void compose_alarm_data(const Alarm_struct* alarm, uint16_t* value_H, uint16_t* value_L)
+{
+    *value_H = (alarm->minute & 0x3F) | ((alarm->hour & 0x1F) << 6) | ((alarm->alarm_id & 0x1F) << 11);
+    *value_L = (alarm->enabled & 0x01) | ((alarm->repeat & 0x01) << 1) | ((alarm->weekdays & 0x7F) << 2) |
+               ((alarm->ringtone_id & 0x7F) << 9);
+}
 void alarm_poll()
 {
     static uint8_t last_day = 0xFF;
@@ -66,70 +78,93 @@ void alarm_poll()
                 if (alarms[i].repeat == 0)
                 {
                     alarms[i].enabled = 0;
-                    save_alarms();   // 立即保存
+                    persist_mark(PERSIST_ALARMS);
                 }
             }
         }
     }
 }
 
-// 在Flash中存储的结构：闹钟数据 + CRC校验值
+#if MAX_ALARMS > KV_ALARM_KEYS
+#error "MAX_ALARMS exceeds the alarm keys reserved in kv_store.h"
+#endif
+
+// 旧版固件在 FLASH_ALARM_ADDR 保存的闹钟镜像：闹钟数据 + CRC校验值
 #define ALARMS_DATA_SIZE sizeof(alarms)                  // 闹钟数据部分长度
 #define CRC_SIZE sizeof(uint16_t)                        // CRC校验值长度
 #define TOTAL_STORE_SIZE (ALARMS_DATA_SIZE + CRC_SIZE)   // 总存储长度
 
-void alarm_init(void)
+// 键值存储中没有闹钟时，从旧版镜像迁移
+static bool _load_legacy_alarms(void)
 {
     uint8_t  flash_buffer[TOTAL_STORE_SIZE];
-    uint16_t stored_crc, computed_crc;
+    uint16_t stored_crc;
 
-    // 从Flash读取数据
     flash_read(FLASH_ALARM_ADDR, flash_buffer, TOTAL_STORE_SIZE);
+    memcpy(&stored_crc, flash_buffer + ALARMS_DATA_SIZE, CRC_SIZE);
+    if (stored_crc != _calc_check_value(flash_buffer, ALARMS_DATA_SIZE)) return false;
 
-    // 提取CRC校验值（小端模式）
-    stored_crc = *((uint16_t*)(flash_buffer + ALARMS_DATA_SIZE));
+    memcpy(alarms, flash_buffer, ALARMS_DATA_SIZE);
+    save_alarms();
+    return true;
+}
 
-    // 计算数据部分CRC
-    computed_crc = _calc_check_value(flash_buffer, ALARMS_DATA_SIZE);
+void alarm_init(void)
+{
+    bool found = false;
 
-    if (stored_crc == computed_crc)
+    // 每个闹钟一条记录，按 REG_ALARM_SET_HIGH/LOW 的格式保存
+    for (uint8_t i = 0; i < MAX_ALARMS; i++)
     {
-        memcpy(alarms, flash_buffer, ALARMS_DATA_SIZE);
-        // beep_start(50, 5); // 启动蜂鸣器，提示闹钟加载成功
+        uint8_t data[4];
+        if (kv_read((KvKey)(KV_KEY_ALARM_BASE + i), data, sizeof(data)) == sizeof(data))
+        {
+            parse_alarm_data(_to_uint16(data), _to_uint16(data + 2), &alarms[i]);
+            found = true;
+        }
+        else
+        {
+            memset(&alarms[i], 0, sizeof(Alarm_struct));
+        }
     }
-    else
+
+    if (!found && !_load_legacy_alarms())
     {
-        // CRC校验失败处理
         memset(alarms, 0, ALARMS_DATA_SIZE);   // 清空闹钟
-        save_alarms();                         // 写入默认值
     }
 }
 
-// 保存闹钟（自动添加CRC）
+// 保存闹钟：只有内容变化的闹钟会追加记录，不擦除Flash
 void save_alarms()
 {
-    uint8_t  flash_buffer[TOTAL_STORE_SIZE];
-    uint16_t crc_value;
-
-    // 拷贝闹钟数据
-    memcpy(flash_buffer, alarms, ALARMS_DATA_SIZE);
-
-    // 计算并存储CRC
-    crc_value = _calc_check_value(flash_buffer, ALARMS_DATA_SIZE);
-    memcpy(flash_buffer + ALARMS_DATA_SIZE, &crc_value, CRC_SIZE);
+    for (uint8_t i = 0; i < MAX_ALARMS; i++)
+    {
+        uint16_t value_H, value_L;
+        uint8_t  data[4];
 
-    // 写入Flash
-    flash_write(FLASH_ALARM_ADDR, flash_buffer, TOTAL_STORE_SIZE);
+        compose_alarm_data(&alarms[i], &value_H, &value_L);
+        _from_uint16(value_H, data);
+        _from_uint16(value_L, data + 2);
+        kv_write((KvKey)(KV_KEY_ALARM_BASE + i), data, sizeof(data));
+    }
 }
 
 void delete_alarm(uint8_t index)
 {
     // 删除闹钟逻辑
     memset(&alarms[index], 0, sizeof(Alarm_struct));
-    save_alarms();
+    persist_mark(PERSIST_ALARMS);
 }
 
 
+// 模块切换到音乐模式后播放铃声
+static void ring_play_callback(MultiTimer* timer, void* arg)
+{
+    // send_at_command("AT+CA00\r\n", 50);
+    // 播放铃声
+    AT_PRINTF("AT+AB%02d\r\n", (uint8_t)(uintptr_t)arg);
+}
+
 void ring_alarm(uint8_t ringtone_id)
 {
     ring_flag = true;
@@ -137,11 +172,7 @@ void ring_alarm(uint8_t ringtone_id)
     // 启动基础音频（5秒20%占空比）
     // beep_start(500, 20);
     mode_control(MUSIC_MODE);
-    HAL_Delay(1000);
-    // send_at_command("AT+CA00\r\n", 50);
-    // 播放铃声
-    AT_PRINTF("AT+AB%02d\r\n", ringtone_id);
-    HAL_Delay(100);
+    multiTimerStart(&ring_play_timer, RING_MODE_SWITCH_MS, ring_play_callback, (void*)(uintptr_t)ringtone_id);
 }
 
 void ring_Gradually_increase()
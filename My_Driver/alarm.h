@@ -17,11 +17,13 @@ typedef struct
 } Alarm_struct;
 
 #define MAX_ALARMS 10
+#define RING_MODE_SWITCH_MS 1000   // 响铃时等待模块切换到音乐模式的时间
 #include <stdbool.h>
 extern bool ring_flag;
 extern Alarm_struct alarms[MAX_ALARMS];
 
 void parse_alarm_data(uint16_t value_H, uint16_t value_L, Alarm_struct* alarm);
+void compose_alarm_data(const Alarm_struct* alarm, uint16_t* value_H, uint16_t* value_L);
 
 void alarm_poll(void);
 
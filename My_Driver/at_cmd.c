@@ -0,0 +1,149 @@
+#include "at_cmd.h"
+#include "MultiTimer.h"
+#include "bt401.h"
+#include "main.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+typedef struct
+{
+    char cmd[AT_CMD_MAX_LEN + 1];
+    const char* prefix;   // 查询应答前缀，NULL 表示只等待 OK/ER
+    uint32_t timeout_ms;
+    AT_Callback callback;
+    void* arg;
+} AT_Command;
+
+static AT_Command _Queue[AT_QUEUE_SIZE];
+static uint8_t _QueueHead  = 0;
+static uint8_t _QueueCount = 0;
+static bool _InFlight      = false;   // 队首指令已发送，正在等待应答
+static uint32_t _SentTick  = 0;
+static char _Line[AT_LINE_MAX_LEN + 1];
+static uint8_t _LineLen = 0;
+static MultiTimer _AtTimer;
+
+// 发送队首指令
+static void _transmit_head(void)
+{
+    if (_InFlight || _QueueCount == 0) return;
+
+    BT401_Printf("%s\r\n", _Queue[_QueueHead].cmd);
+    _SentTick = HAL_GetTick();
+    _LineLen  = 0;
+    _InFlight = true;
+}
+
+// 队首指令完成：先出队再回调，回调中可以继续入队
+static void _complete(AT_Result result, const char* response)
+{
+    AT_Command done = _Queue[_QueueHead];
+    _QueueHead      = (_QueueHead + 1) % AT_QUEUE_SIZE;
+    _QueueCount--;
+    _InFlight = false;
+
+    if (done.callback) done.callback(result, response, done.arg);
+}
+
+// 一行应答接收完成，判断是否为当前指令的结束
+static void _match_line(void)
+{
+    const AT_Command* cmd = &_Queue[_QueueHead];
+    _Line[_LineLen]       = '\0';
+
+    if (cmd->prefix && strncmp(_Line, cmd->prefix, strlen(cmd->prefix)) == 0)
+        _complete(AT_RESULT_OK, _Line);
+    else if (strncmp(_Line, "OK", 2) == 0)
+        _complete(AT_RESULT_OK, _Line);
+    else if (strncmp(_Line, "ER", 2) == 0)
+        _complete(AT_RESULT_ERROR, _Line);
+}
+
+// 逐字节读取接收缓冲区，直到当前指令完成，避免吞掉之后属于协议帧的数据
+static void _process(void)
+{
+    uint8_t byte;
+    while (_InFlight && BT401_Read(&byte, 1) == 1)
+    {
+        if (byte == '\r' || byte == '\n')
+        {
+            if (_LineLen > 0) _match_line();
+            _LineLen = 0;
+        } else if (byte != 0x00 && _LineLen < AT_LINE_MAX_LEN)   // 模块应答中夹带的0x00直接丢弃
+        {
+            _Line[_LineLen++] = (char)byte;
+        }
+    }
+
+    if (_InFlight && HAL_GetTick() - _SentTick >= _Queue[_QueueHead].timeout_ms)
+    {
+        _complete(AT_RESULT_TIMEOUT, "");
+    }
+
+    _transmit_head();
+}
+
+static void at_task_callback(MultiTimer* timer, void* arg)
+{
+    _process();
+    if (_QueueCount == 0) multiTimerStop(timer);   // 队列清空，停止轮询
+}
+
+static bool _enqueue(const char* cmd, const char* prefix, uint32_t timeout_ms, AT_Callback callback, void* arg)
+{
+    size_t len = strlen(cmd);
+    while (len > 0 && (cmd[len - 1] == '\r' || cmd[len - 1] == '\n')) len--;   // 结尾统一由引擎补\r\n
+    if (len == 0 || len > AT_CMD_MAX_LEN || _QueueCount >= AT_QUEUE_SIZE) return false;
+
+    AT_Command* slot = &_Queue[(_QueueHead + _QueueCount) % AT_QUEUE_SIZE];
+    memcpy(slot->cmd, cmd, len);
+    slot->cmd[len]   = '\0';
+    slot->prefix     = prefix;
+    slot->timeout_ms = timeout_ms;
+    slot->callback   = callback;
+    slot->arg        = arg;
+    _QueueCount++;
+
+    if (_QueueCount == 1)
+    {
+        multiTimerStartPeriodic(&_AtTimer, AT_POLL_MS, at_task_callback, NULL);
+    }
+    _transmit_head();
+    return true;
+}
+
+bool at_send(const char* cmd, uint32_t timeout_ms, AT_Callback callback, void* arg)
+{
+    if (!cmd) return false;
+    return _enqueue(cmd, NULL, timeout_ms, callback, arg);
+}
+
+bool at_query(const char* cmd, const char* prefix, uint32_t timeout_ms, AT_Callback callback, void* arg)
+{
+    if (!cmd || !prefix) return false;
+    return _enqueue(cmd, prefix, timeout_ms, callback, arg);
+}
+
+bool at_printf(const char* format, ...)
+{
+    char buf[AT_CMD_MAX_LEN + 3];   // 预留格式串自带的\r\n
+    va_list args;
+
+    va_start(args, format);
+    int len = vsnprintf(buf, sizeof(buf), format, args);
+    va_end(args);
+
+    if (len < 0 || len >= (int)sizeof(buf)) return false;
+    return at_send(buf, AT_TIMEOUT, NULL, NULL);
+}
+
+bool at_owns_rx(void)
+{
+    return _InFlight;
+}
+
+bool at_busy(void)
+{
+    return _QueueCount > 0;
+}
@@ -0,0 +1,41 @@
+#ifndef __AT_CMD_H
+#define __AT_CMD_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * BT401 异步AT指令引擎。
+ * - 指令进入队列，前一条收到 "OK"/"ER"（或查询前缀应答）或超时后才发送下一条，不再 HAL_Delay 盲等。
+ * - 指令在途期间由引擎独占串口接收环形缓冲区，逐字节按行匹配应答；空闲时由协议解析读取。
+ * - 轮询与完成回调都在引擎内部的 MultiTimer 任务中执行，队列清空后该任务自动停止。
+ */
+#define AT_QUEUE_SIZE 16     // 指令队列深度
+#define AT_CMD_MAX_LEN 24    // 单条指令最大长度（不含结尾的\r\n）
+#define AT_LINE_MAX_LEN 64   // 单行应答最大长度
+#define AT_POLL_MS 2         // 指令在途时的接收轮询周期
+
+typedef enum
+{
+    AT_RESULT_OK = 0,   // 收到 OK 或查询前缀应答
+    AT_RESULT_ERROR,    // 收到 ER
+    AT_RESULT_TIMEOUT   // 超时未收到应答
+} AT_Result;
+
+// 完成回调：response 为匹配到的应答行（不含\r\n），仅在回调期间有效
+typedef void (*AT_Callback)(AT_Result result, const char* response, void* arg);
+
+// 指令入队，cmd 末尾的\r\n可有可无；返回false表示队列已满或指令过长
+bool at_send(const char* cmd, uint32_t timeout_ms, AT_Callback callback, void* arg);
+// 查询指令入队，收到以 prefix 开头的应答行即视为完成（prefix 需为静态字符串）
+bool at_query(const char* cmd, const char* prefix, uint32_t timeout_ms, AT_Callback callback, void* arg);
+// 格式化后入队，超时 AT_TIMEOUT，无回调
+bool at_printf(const char* format, ...);
+
+// 指令在途期间串口接收由引擎独占
+bool at_owns_rx(void);
+// 队列中仍有未完成的指令
+bool at_busy(void);
+
+#endif   // __AT_CMD_H
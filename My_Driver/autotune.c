@@ -0,0 +1,209 @@
+#include "autotune.h"
+#include "kv_store.h"
+#include "persist.h"
+#include "register_interface.h"
+#include <math.h>
+#include <string.h>
+
+#define TUNING_VERSION 1   // 整定记录版本，修改 TuningRecord 时递增
+#define PI 3.14159265f
+
+// 保存在参数存储区 KV_KEY_TUNING 中的整定结果
+typedef struct
+{
+    uint8_t version;            // TUNING_VERSION，0 表示没有整定结果
+    uint8_t reserved;
+    uint16_t dead_time_s;       // 纯滞后 L（秒），仅记录
+    uint16_t time_constant_s;   // 时间常数 τ（秒），仅记录
+    uint16_t reserved2;
+    int32_t kp;                 // PID 参数（Q16.16）
+    int32_t ki;
+    int32_t kd;
+    int32_t ff_gain;            // 每升温1℃所需的稳态输出（%/℃，Q16.16），0 表示没有前馈
+} TuningRecord;
+
+// 继电器整定过程
+typedef struct
+{
+    AutotuneState state;
+    bool relay_on;
+    uint8_t cycles;               // 继电器重新开启的次数，每次结束一个振荡周期
+    uint8_t measured;             // 已测量的周期数
+    int16_t ambient_q88;          // 开始整定时的温度
+    int16_t peak_high_q88;        // 本周期最高温度
+    int16_t peak_low_q88;         // 本周期最低温度
+    uint32_t elapsed_ms;          // 整定已进行的时间
+    uint32_t cycle_start_ms;      // 本周期开始的时间
+    uint32_t cycle_on_ms;         // 本周期内继电器开启的时间
+    uint32_t period_sum_ms;       // 已测量周期的总时长
+    uint32_t on_sum_ms;           // 已测量周期内继电器开启的总时长
+    int32_t amplitude_sum_q88;    // 已测量周期的幅值之和
+} AutotuneRun;
+
+static TuningRecord _Tuning;   // 当前使用的整定结果
+static AutotuneRun _Run;
+static int16_t _Ambient = 0;   // 加热开始时的温度（Q8.8）
+
+static void _apply(PID_Controller* pid)
+{
+    pid->Kp = _Tuning.kp;
+    pid->Ki = _Tuning.ki;
+    pid->Kd = _Tuning.kd;
+    PID_Reset(pid);
+}
+
+static void _set_state(AutotuneState state)
+{
+    _Run.state = state;
+    register_set_value(REG_AUTOTUNE, state);
+}
+
+// 由测得的幅值和周期计算 PID 参数和 FOPDT 模型，只在整定结束时执行一次，使用浮点
+static bool _identify(void)
+{
+    float a  = _Run.amplitude_sum_q88 / (256.0f * AUTOTUNE_CYCLES);   // 振荡幅值（℃）
+    float tu = _Run.period_sum_ms / (1000.0f * AUTOTUNE_CYCLES);      // 振荡周期（秒）
+    if (a <= 0.0f || tu <= 0.0f) return false;
+
+    // 临界增益与 Tyreus-Luyben 参数：Kp = Ku/2.2，Ti = 2.2Tu，Td = Tu/6.3
+    float ku = 4.0f * (AUTOTUNE_OUTPUT_HIGH / 2.0f) / (PI * a);
+    float kp = ku / 2.2f;
+    float ki = kp / (2.2f * tu);
+    float kd = kp * tu / 6.3f;
+
+    // FOPDT：稳态增益 K = 温升 / 平均输出；临界点满足 K·Ku = sqrt(1 + (ωτ)²)，ωL + atan(ωτ) = π
+    float omega   = 2.0f * PI / tu;
+    float u_avg   = AUTOTUNE_OUTPUT_HIGH * (float)_Run.on_sum_ms / _Run.period_sum_ms;
+    float rise    = (AUTOTUNE_SETPOINT_Q88 - _Run.ambient_q88) / 256.0f;
+    float tau     = 0.0f;
+    float dead    = tu / 2.0f;   // 模型不一致时按纯滞后对象估计
+    float ff_gain = 0.0f;
+    if (rise > 1.0f && u_avg > 0.0f)
+    {
+        float k = rise / u_avg;
+        ff_gain = 1.0f / k;
+        if (k * ku > 1.0f)
+        {
+            tau  = sqrtf(k * ku * k * ku - 1.0f) / omega;
+            dead = (PI - atanf(omega * tau)) / omega;
+        }
+    }
+
+    _Tuning.version         = TUNING_VERSION;
+    _Tuning.reserved        = 0;
+    _Tuning.dead_time_s     = (uint16_t)(dead + 0.5f);
+    _Tuning.time_constant_s = (tau < 65535.0f) ? (uint16_t)(tau + 0.5f) : 65535;
+    _Tuning.reserved2       = 0;
+    _Tuning.kp              = PID_Q16(kp);
+    _Tuning.ki              = PID_Q16(ki);
+    _Tuning.kd              = PID_Q16(kd);
+    _Tuning.ff_gain         = PID_Q16(ff_gain);
+    return true;
+}
+
+void autotune_init(PID_Controller* pid)
+{
+    TuningRecord record;
+    if (kv_read(KV_KEY_TUNING, &record, sizeof(record)) == sizeof(record) && record.version == TUNING_VERSION)
+    {
+        _Tuning = record;
+        _apply(pid);
+    }
+}
+
+void autotune_start(void)
+{
+    if (_Run.state == AUTOTUNE_RUNNING) return;
+
+    memset(&_Run, 0, sizeof(_Run));
+    _Run.relay_on = true;
+    _set_state(AUTOTUNE_RUNNING);
+    register_set_value(REG_HEATING_STATUS, 1);   // 整定期间加热保持开启，关闭加热即取消
+}
+
+void autotune_abort(void)
+{
+    if (_Run.state == AUTOTUNE_RUNNING) _set_state(AUTOTUNE_IDLE);
+}
+
+bool autotune_active(void)
+{
+    return _Run.state == AUTOTUNE_RUNNING;
+}
+
+uint16_t autotune_step(PID_Controller* pid, int16_t temp_q88, uint16_t dt_ms)
+{
+    if (_Run.elapsed_ms == 0)
+    {
+        _Run.ambient_q88   = temp_q88;
+        _Run.peak_high_q88 = temp_q88;
+        _Run.peak_low_q88  = temp_q88;
+    } else if (_Run.relay_on)
+    {
+        _Run.cycle_on_ms += dt_ms;   // 上一次的输出作用了 dt_ms
+    }
+    _Run.elapsed_ms += dt_ms;
+
+    // 温度过高或超时：放弃整定并关闭加热
+    if (temp_q88 >= AUTOTUNE_ABORT_Q88 || _Run.elapsed_ms >= AUTOTUNE_TIMEOUT_S * 1000u)
+    {
+        _set_state(AUTOTUNE_FAILED);
+        register_set_value(REG_HEATING_STATUS, 0);
+        return 0;
+    }
+
+    if (temp_q88 > _Run.peak_high_q88) _Run.peak_high_q88 = temp_q88;
+    if (temp_q88 < _Run.peak_low_q88) _Run.peak_low_q88 = temp_q88;
+
+    if (_Run.relay_on && temp_q88 > AUTOTUNE_SETPOINT_Q88 + AUTOTUNE_HYSTERESIS_Q88)
+    {
+        _Run.relay_on = false;
+    } else if (!_Run.relay_on && temp_q88 < AUTOTUNE_SETPOINT_Q88 - AUTOTUNE_HYSTERESIS_Q88)
+    {
+        // 继电器重新开启，一个振荡周期结束；升温过程与第一个完整周期受初始状态影响，不参与计算
+        _Run.relay_on = true;
+        if (++_Run.cycles > AUTOTUNE_SKIP_CYCLES)
+        {
+            _Run.period_sum_ms += _Run.elapsed_ms - _Run.cycle_start_ms;
+            _Run.on_sum_ms += _Run.cycle_on_ms;
+            _Run.amplitude_sum_q88 += (_Run.peak_high_q88 - _Run.peak_low_q88) / 2;
+            _Run.measured++;
+        }
+        _Run.cycle_start_ms = _Run.elapsed_ms;
+        _Run.cycle_on_ms    = 0;
+        _Run.peak_high_q88  = temp_q88;
+        _Run.peak_low_q88   = temp_q88;
+
+        if (_Run.measured >= AUTOTUNE_CYCLES)
+        {
+            if (_identify())
+            {
+                _apply(pid);
+                persist_mark(PERSIST_TUNING);
+                _set_state(AUTOTUNE_DONE);
+            } else
+            {
+                _set_state(AUTOTUNE_FAILED);
+                register_set_value(REG_HEATING_STATUS, 0);
+            }
+            return 0;
+        }
+    }
+    return _Run.relay_on ? AUTOTUNE_OUTPUT_HIGH : 0;
+}
+
+void autotune_save(void)
+{
+    if (_Tuning.version == TUNING_VERSION) kv_write(KV_KEY_TUNING, &_Tuning, sizeof(_Tuning));
+}
+
+void heater_model_begin(int16_t temp_q88)
+{
+    _Ambient = temp_q88;
+}
+
+int32_t heater_model_feedforward(int16_t setpoint_q88)
+{
+    if (_Tuning.ff_gain == 0 || setpoint_q88 <= _Ambient) return 0;
+    return (int32_t)(((int64_t)(setpoint_q88 - _Ambient) * _Tuning.ff_gain) >> 8);   // Q8.8 × Q16.16 >> 8
+}
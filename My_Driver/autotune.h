@@ -0,0 +1,49 @@
+#ifndef __AUTOTUNE_H
+#define __AUTOTUNE_H
+
+#include "pid.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * 加热器继电器自整定（Åström-Hägglund）与一阶惯性加纯滞后（FOPDT）模型。
+ * - 寄存器 REG_AUTOTUNE 写1开始整定：打开加热，以 AUTOTUNE_SETPOINT_Q88 为中心做带回差的继电器控制（全功率/关闭），
+ *   跳过 AUTOTUNE_SKIP_CYCLES 个周期后测量 AUTOTUNE_CYCLES 个周期的幅值 a 和周期 Tu，得到临界增益 Ku = 4d/(πa)，
+ *   按 Tyreus-Luyben 规则（比 Ziegler-Nichols 超调小）计算 PID 参数。
+ * - 由继电器平均占空比与起始温度估算稳态增益 K，结合 Ku、Tu 求出时间常数 τ 和纯滞后 L。
+ *   参数立即生效并保存到参数存储区，开机时加载。
+ * - 控温时加上前馈输出 (设定值 - 加热开始时的温度) / K，PID 的积分只修正模型误差（见 PID_FF_INTEGRAL_BAND_Q88）。
+ * - 温度达到 AUTOTUNE_ABORT_Q88 或超时则整定失败，原有参数不变；关闭加热即取消整定。
+ */
+#define AUTOTUNE_SETPOINT_Q88 (45 * 256)    // 整定中心温度，中间档位
+#define AUTOTUNE_HYSTERESIS_Q88 (256 / 2)   // 继电器回差 ±0.5℃，大于温度噪声
+#define AUTOTUNE_OUTPUT_HIGH 100            // 继电器开启时的输出
+#define AUTOTUNE_SKIP_CYCLES 2              // 不参与计算的周期：升温过程与第一个完整振荡周期
+#define AUTOTUNE_CYCLES 3                   // 参与计算的振荡周期数
+#define AUTOTUNE_ABORT_Q88 (60 * 256)       // 达到此温度放弃整定，低于 65℃ 过热保护阈值
+#define AUTOTUNE_TIMEOUT_S (40 * 60)        // 整定最长时间
+
+typedef enum
+{
+    AUTOTUNE_IDLE = 0,   // 未整定或已取消
+    AUTOTUNE_RUNNING,    // 整定中
+    AUTOTUNE_DONE,       // 整定完成，参数已应用并保存
+    AUTOTUNE_FAILED,     // 整定失败，参数未改变
+} AutotuneState;
+
+// 加载已保存的整定结果，没有时保持 pid 的默认参数
+void autotune_init(PID_Controller* pid);
+void autotune_start(void);
+void autotune_abort(void);
+bool autotune_active(void);
+// 整定期间每个控温周期调用，返回继电器输出
+uint16_t autotune_step(PID_Controller* pid, int16_t temp_q88, uint16_t dt_ms);
+// 保存整定结果，由 persist 服务调用
+void autotune_save(void);
+
+// 加热开始时调用，记录起始温度
+void heater_model_begin(int16_t temp_q88);
+// 维持设定值所需的前馈输出（Q16.16），没有模型时为0
+int32_t heater_model_feedforward(int16_t setpoint_q88);
+
+#endif   // __AUTOTUNE_H
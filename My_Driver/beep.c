@@ -1,37 +1,48 @@
 #include "beep.h"
 #include "gpio.h"
 #include "main.h"
+#include "tim.h"
 
-volatile uint16_t pwm_count      = 0;     // 类型修正为 uint16_t
-volatile uint16_t pwm_period     = 200;   // 200kHz/200=1kHz
-volatile uint16_t pwm_duty_cycle = 0;     // 类型修正为 uint16_t
-volatile uint32_t beep_timer     = 0;     // 单位：ms
+/*
+ * PB12 没有可用的定时器输出通道，由 TIM2 比较事件触发 DMA 直接写 GPIOB->BSRR：
+ * 计数频率 200kHz、周期 200（1kHz），CC1（CCR1=0）经 DMA1_Channel5 置位引脚，
+ * CC2（CCR2=占空比）经 DMA1_Channel7 复位引脚。静音时 TIM2 停止，不产生任何中断或 DMA 请求。
+ * 两个通道只由本模块使用，用 HAL_DMA_Start 启动，不开 DMA 中断。
+ */
+#define BEEP_PWM_PERIOD 200   // 200kHz/200=1kHz
 
-// 中断调用
-void beep_pwm_update(void)
+static uint32_t beep_set_bits   = BEEP_Pin;                   // 写入BSRR低16位：置位
+static uint32_t beep_reset_bits = (uint32_t)BEEP_Pin << 16;   // 写入BSRR高16位：复位
+volatile uint32_t beep_timer    = 0;                          // 单位：ms
+
+void beep_init(void)
 {
-    pwm_count++;
-    if (pwm_count >= pwm_period)
-    {
-        pwm_count = 0;
-    }
-    HAL_GPIO_WritePin(BEEP_GPIO_Port, BEEP_Pin, (pwm_count < pwm_duty_cycle) ? GPIO_PIN_SET : GPIO_PIN_RESET);
+    HAL_DMA_Start(htim2.hdma[TIM_DMA_ID_CC1], (uint32_t)&beep_set_bits, (uint32_t)&BEEP_GPIO_Port->BSRR, 1);
+    HAL_DMA_Start(htim2.hdma[TIM_DMA_ID_CC2], (uint32_t)&beep_reset_bits, (uint32_t)&BEEP_GPIO_Port->BSRR, 1);
+    __HAL_TIM_ENABLE_DMA(&htim2, TIM_DMA_CC1 | TIM_DMA_CC2);
+}
+
+static void beep_stop(void)
+{
+    __HAL_TIM_DISABLE(&htim2);
+    HAL_GPIO_WritePin(BEEP_GPIO_Port, BEEP_Pin, GPIO_PIN_RESET);
 }
 
 void beep_start(uint32_t duration_ms, uint8_t duty_cycle)
 {
-    if (duration_ms == 0)
+    if (duration_ms == 0 || duty_cycle == 0)
     {
-        __disable_irq();   // 禁用中断
-        pwm_duty_cycle = 0;
-        __enable_irq();   // 启用中断
+        beep_stop();
         return;
     }
-    // 修正占空比限制逻辑
-    uint16_t clamped_duty = (duty_cycle > pwm_period) ? pwm_period : duty_cycle;
-    __disable_irq();   // 禁用中断
-    pwm_duty_cycle = clamped_duty;
-    __enable_irq();   // 启用中断
+    // 占空比等于周期时 CCR2 不会匹配，引脚保持高电平
+    uint16_t clamped_duty = (duty_cycle > BEEP_PWM_PERIOD) ? BEEP_PWM_PERIOD : duty_cycle;
+    __HAL_TIM_SET_COMPARE(&htim2, TIM_CHANNEL_2, clamped_duty);
+    if ((htim2.Instance->CR1 & TIM_CR1_CEN) == 0)
+    {
+        __HAL_TIM_SET_COUNTER(&htim2, 0);
+        __HAL_TIM_ENABLE(&htim2);
+    }
     beep_timer = duration_ms;
 }
 
@@ -42,9 +53,7 @@ void beep_update(void)
         beep_timer--;
         if (beep_timer == 0)
         {
-            __disable_irq();   // 禁用中断
-            pwm_duty_cycle = 0;
-            __enable_irq();   // 启用中断
+            beep_stop();
         }
     }
 }
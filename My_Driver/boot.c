@@ -0,0 +1,78 @@
+#include "boot.h"
+#include "MultiTimer.h"
+#include "main.h"
+#include "register_interface.h"
+#include <stddef.h>
+
+#define BOOT_TICK_PENDING 0xFFFF   // 阶段尚未完成
+
+static const BootStage* _Stages = NULL;
+static uint8_t _StageCount      = 0;
+static uint32_t _Started        = 0;   // bit n 置位：阶段n已调用 start
+static uint32_t _Done           = 0;   // bit n 置位：阶段n已完成
+static uint16_t _DoneTick[REG_BOOT_TRACE_STAGES];
+static MultiTimer _BootTimer;
+
+// 推进所有可以推进的阶段；一个阶段完成后可能解除其他阶段的依赖，因此重复扫描直到没有变化
+static void _advance(void)
+{
+    bool progress = true;
+    while (progress)
+    {
+        progress = false;
+        for (uint8_t i = 0; i < _StageCount; i++)
+        {
+            const BootStage* stage = &_Stages[i];
+            uint32_t bit           = 1u << i;
+            if ((_Done & bit) || (_Done & stage->depends) != stage->depends) continue;
+            if (HAL_GetTick() < stage->not_before_ms) continue;
+
+            if (!(_Started & bit))
+            {
+                _Started |= bit;
+                if (stage->start) stage->start();
+            }
+            if (stage->done == NULL || stage->done())
+            {
+                uint32_t now = HAL_GetTick();
+                _Done |= bit;
+                _DoneTick[i] = (now < BOOT_TICK_PENDING) ? (uint16_t)now : BOOT_TICK_PENDING - 1;
+                progress     = true;
+            }
+        }
+    }
+}
+
+static void boot_task_callback(MultiTimer* timer, void* arg)
+{
+    _advance();
+    if (boot_finished()) multiTimerStop(timer);   // 启动完成，停止轮询
+}
+
+void boot_start(const BootStage* stages, uint8_t count)
+{
+    _Stages     = stages;
+    _StageCount = (count < REG_BOOT_TRACE_STAGES) ? count : REG_BOOT_TRACE_STAGES;
+    _Started    = 0;
+    _Done       = 0;
+    for (uint8_t i = 0; i < REG_BOOT_TRACE_STAGES; i++)
+    {
+        _DoneTick[i] = BOOT_TICK_PENDING;
+    }
+
+    _advance();
+    if (!boot_finished())
+    {
+        multiTimerStartPeriodic(&_BootTimer, BOOT_POLL_MS, boot_task_callback, NULL);
+    }
+}
+
+bool boot_finished(void)
+{
+    return _Done == (1u << _StageCount) - 1;
+}
+
+uint16_t boot_trace_get_register(uint16_t offset)
+{
+    return (offset < REG_BOOT_TRACE_STAGES) ? _DoneTick[offset] : 0;
+}
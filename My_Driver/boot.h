@@ -0,0 +1,31 @@
+#ifndef __BOOT_H
+#define __BOOT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * 按依赖顺序异步执行的启动流程。
+ * - 每个阶段声明依赖的阶段和上电后最早开始时间，依赖全部完成且时间已到时调用一次 start，之后 done 返回 true 即完成。
+ * - 不需要等待的阶段在 boot_start() 中立即依次完成；需要等待的阶段（蓝牙模块上电、AT指令应答）由 MultiTimer
+ *   任务每 BOOT_POLL_MS 推进一次，等待期间主循环照常调度按键、LED、控温、闹钟等任务。
+ * - 每个阶段完成时记录 HAL_GetTick()，可从寄存器 REG_BOOT_TRACE_BASE 起读取。
+ */
+#define BOOT_POLL_MS 10   // 等待中的阶段的轮询周期
+
+typedef struct
+{
+    uint32_t depends;         // 依赖的阶段位图，bit n 对应表中第n个阶段
+    uint16_t not_before_ms;   // 上电后最早开始时间
+    void (*start)(void);      // 开始时调用一次，可为 NULL
+    bool (*done)(void);       // 完成条件，NULL 表示 start 返回即完成
+} BootStage;
+
+// 开始执行启动流程，stages 须为静态表，阶段数不超过 REG_BOOT_TRACE_STAGES
+void boot_start(const BootStage* stages, uint8_t count);
+// 所有阶段均已完成
+bool boot_finished(void);
+// 读取启动时间寄存器，offset 为阶段序号，返回该阶段完成时的毫秒数，0xFFFF 表示尚未完成
+uint16_t boot_trace_get_register(uint16_t offset);
+
+#endif   // __BOOT_H
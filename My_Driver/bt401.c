@@ -6,83 +6,176 @@
 #include "usart.h"
 
 #define USARTx_HANDLE huart3
-#define UART_RX_BUFFER_SIZE 1             // 每次只接收一个字节
-#define RING_RX_SIZE 512                  // 缓存区大小
+#define RING_RX_SIZE 512                  // 缓存区大小，必须为2的幂（head/tail 为自由计数，依赖 65536 整除）
+#define RING_TX_SIZE 512                  // 发送缓存区大小，必须为2的幂
 #define BT401_TX_FORMAT_BUFFER_SIZE 128   // 根据需求调整缓冲区大小
 
-/* 私有全局变量 */
+/*
+ * 接收：USART3 RX 以循环模式 DMA 直接写入 rx_ring.buffer，由 DMA 半满/全满与串口空闲中断
+ * （HAL_UARTEx_RxEventCallback）推进 head，一帧数据只产生一两次中断。
+ * head 仅在中断中写、tail 仅在读取方写，均为16位原子访问，读写两端都无需关中断。
+ */
 #pragma pack(push, 1)
 typedef struct
 {
-    volatile uint16_t head;
-    volatile uint16_t tail;
+    volatile uint16_t head;   // 已写入字节的自由计数
+    volatile uint16_t tail;   // 已读取字节的自由计数
     uint8_t buffer[RING_RX_SIZE];
-    volatile uint8_t overflow;   // 缓冲区溢出标志
+    volatile uint8_t overflow;   // 缓冲区溢出标志（未读数据被DMA覆盖）
+    volatile uint8_t resync;     // DMA已从缓冲区起点重启，读取方需丢弃之前的数据
 } RingBuffer;
 
 RingBuffer rx_ring = {0};
-uint8_t uart_rx_buffer[UART_RX_BUFFER_SIZE];   // 接收缓冲区
 #pragma pack(pop)
 
+/*
+ * 发送：数据拷贝进 tx_ring 后立即返回，由 hdma_usart3_tx 按连续段发送，
+ * 每段发送完成（HAL_UART_TxCpltCallback）后接着发送下一段。
+ * head 仅由写入方推进，tail/sending 仅在发送完成中断及关中断的启动段中修改。
+ */
+typedef struct
+{
+    volatile uint16_t head;      // 已入队字节的自由计数
+    volatile uint16_t tail;      // 已发送完成字节的自由计数
+    volatile uint16_t sending;   // 正在DMA发送的段长度，0 表示空闲
+    uint8_t buffer[RING_TX_SIZE];
+} TxRingBuffer;
+
+static TxRingBuffer tx_ring   = {0};
+static BT401_TxStats tx_stats = {0};
+
+static void UART_TxKick(void);
+
 /* 初始化函数 */
 void UART_Init(void)
 {
-    // 先执行HAL_UART_MspInit（CubeMX生成）
+    // 先执行HAL_UART_MspInit（CubeMX生成，hdma_usart3_rx 为循环模式）
 
-    // 启动中断接收方式，每次接收一个字节
-    HAL_UART_Receive_IT(&USARTx_HANDLE, uart_rx_buffer, 1);
+    // 启动循环DMA接收，串口空闲、半满、全满时回调 HAL_UARTEx_RxEventCallback
+    HAL_UARTEx_ReceiveToIdle_DMA(&USARTx_HANDLE, rx_ring.buffer, RING_RX_SIZE);
 }
 
-/* UART接收完成回调函数 */
-void HAL_UART_RxCpltCallback(UART_HandleTypeDef* huart)
+/* 串口接收事件回调：pos 为 DMA 在缓冲区中的写入位置 */
+void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef* huart, uint16_t pos)
 {
     if (huart == &USARTx_HANDLE)
     {
-        // 将接收到的字节放入环形缓冲区
-        uint8_t received_byte = uart_rx_buffer[0];
-
-        __disable_irq();
+        // 计算自上次事件以来DMA新写入的字节数，推进自由计数的head
+        uint16_t received = (pos - rx_ring.head) & (RING_RX_SIZE - 1);
+        if (received == 0 && pos == RING_RX_SIZE && huart->RxEventType == HAL_UART_RXEVENT_TC)
+        {
+            received = RING_RX_SIZE;   // 上次事件后恰好写满一圈
+        }
+        rx_ring.head += received;
+    }
+}
 
-        uint16_t free_space = RING_RX_SIZE - ((rx_ring.head - rx_ring.tail) & (RING_RX_SIZE - 1));
-        if (free_space > 0)
+/* 串口错误（溢出/噪声/帧错误/DMA错误）会中止DMA收发，恢复发送并重新启动接收 */
+void HAL_UART_ErrorCallback(UART_HandleTypeDef* huart)
+{
+    if (huart == &USARTx_HANDLE)
+    {
+        // DMA发送出错时HAL已结束发送，重发当前段
+        if (tx_ring.sending && huart->gState == HAL_UART_STATE_READY)
         {
-            uint16_t write_idx        = rx_ring.head & (RING_RX_SIZE - 1);
-            rx_ring.buffer[write_idx] = received_byte;
-            rx_ring.head += 1;
-            rx_ring.overflow = 0;
-        } else
+            tx_ring.sending = 0;
+            UART_TxKick();
+        }
+
+        // 接收已被HAL中止：DMA从缓冲区起点重新写入，head 对齐到下一圈起点
+        if (huart->RxState == HAL_UART_STATE_READY)
         {
-            rx_ring.overflow = 1;   // 缓冲区溢出
+            rx_ring.head   = (rx_ring.head + RING_RX_SIZE - 1) & ~(RING_RX_SIZE - 1);
+            rx_ring.resync = 1;
+            UART_Init();
         }
+    }
+}
+
+/* 启动下一段DMA发送，需在关中断或发送完成中断中调用 */
+static void UART_TxKick(void)
+{
+    uint16_t pending = tx_ring.head - tx_ring.tail;
+    if (tx_ring.sending || pending == 0) return;
+
+    // 每次只发送到缓冲区末尾的连续段，回绕部分在完成回调中接着发送
+    uint16_t index = tx_ring.tail & (RING_TX_SIZE - 1);
+    uint16_t len   = RING_TX_SIZE - index;
+    if (len > pending) len = pending;
 
-        __enable_irq();
+    if (HAL_UART_Transmit_DMA(&USARTx_HANDLE, &tx_ring.buffer[index], len) == HAL_OK)
+    {
+        tx_ring.sending = len;
+        tx_stats.dma_transfers++;
+    }
+}
 
-        // 继续下一次中断接收
-        HAL_UART_Receive_IT(huart, uart_rx_buffer, 1);
+/* 串口发送完成回调：释放已发送的段并接着发送 */
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef* huart)
+{
+    if (huart == &USARTx_HANDLE)
+    {
+        uint32_t start = DWT->CYCCNT;
+        tx_ring.tail += tx_ring.sending;
+        tx_stats.bytes_sent += tx_ring.sending;
+        tx_ring.sending = 0;
+        UART_TxKick();
+        tx_stats.cpu_cycles += DWT->CYCCNT - start;
     }
 }
 
-/* 发送数据函数（阻塞改非阻塞）*/
+/* 发送数据函数（入队后立即返回，队列空间不足时整包拒绝并返回0）*/
 uint16_t UART_Write(const uint8_t* data, uint16_t len)
 {
     if (len == 0 || data == NULL) return 0;
 
-    // 直接调用中断发送
-    if (HAL_UART_Transmit(&USARTx_HANDLE, (uint8_t*)data, len, HAL_MAX_DELAY) == HAL_OK)
+    uint32_t start      = DWT->CYCCNT;
+    uint16_t free_space = RING_TX_SIZE - (uint16_t)(tx_ring.head - tx_ring.tail);
+    if (len > free_space)
     {
-        return len;
+        tx_stats.bytes_dropped += len;   // 队列满，由调用方决定是否重试
+        return 0;
+    }
+
+    uint16_t write_idx = tx_ring.head & (RING_TX_SIZE - 1);
+    if (write_idx + len <= RING_TX_SIZE)
+    {
+        memcpy(&tx_ring.buffer[write_idx], data, len);
     } else
     {
-        return 0;   // 发送失败
+        uint16_t first_part = RING_TX_SIZE - write_idx;
+        memcpy(&tx_ring.buffer[write_idx], data, first_part);
+        memcpy(tx_ring.buffer, data + first_part, len - first_part);
     }
+    tx_ring.head += len;
+
+    __disable_irq();
+    UART_TxKick();
+    tx_stats.bytes_queued += len;
+    tx_stats.cpu_cycles += DWT->CYCCNT - start;
+    __enable_irq();
+    return len;
 }
 
 /* 数据读取接口 */
 uint16_t UART_Read(uint8_t* buf, uint16_t max_len)
 {
-    __disable_irq();
+    if (rx_ring.resync)
+    {
+        rx_ring.resync   = 0;
+        rx_ring.overflow = 1;
+        rx_ring.tail     = rx_ring.head & ~(RING_RX_SIZE - 1);   // 只保留重启后收到的数据
+    }
 
-    uint16_t available = (rx_ring.head - rx_ring.tail) & (RING_RX_SIZE - 1);
+    uint16_t head      = rx_ring.head;
+    uint16_t available = head - rx_ring.tail;
+    if (available > RING_RX_SIZE)
+    {
+        // DMA已覆盖未读数据，只保留最近一整圈
+        rx_ring.overflow = 1;
+        rx_ring.tail     = head - RING_RX_SIZE;
+        available        = RING_RX_SIZE;
+    }
     if (max_len > available) max_len = available;
 
     if (max_len > 0)
@@ -102,14 +195,13 @@ uint16_t UART_Read(uint8_t* buf, uint16_t max_len)
         rx_ring.tail += max_len;
     }
 
-    __enable_irq();
     return max_len;
 }
 
 /// @brief 初始化蓝牙模块
 void BT401_Init(void)
 {
-    UART_Init();   // 初始化UART和中断接收
+    UART_Init();   // 初始化UART和DMA接收
 }
 
 uint16_t BT401_Read(uint8_t* buffer, uint16_t size)
@@ -122,6 +214,23 @@ uint16_t BT401_Write(uint8_t* buffer, uint16_t size)
     return UART_Write(buffer, size);   // 发送数据
 }
 
+bool BT401_TxBusy(void)
+{
+    return tx_ring.head != tx_ring.tail;
+}
+
+uint16_t BT401_TxFree(void)
+{
+    return RING_TX_SIZE - (uint16_t)(tx_ring.head - tx_ring.tail);   // 发送完成中断只会让空间变大
+}
+
+void BT401_GetTxStats(BT401_TxStats* stats)
+{
+    __disable_irq();
+    *stats = tx_stats;
+    __enable_irq();
+}
+
 uint16_t BT401_Printf(const char* format, ...)
 {
     static char fmt_buf[BT401_TX_FORMAT_BUFFER_SIZE];
@@ -1,8 +1,10 @@
 #ifndef __BT401_H
 #define __BT401_H
 
+#include "at_cmd.h"
 #include "stm32f1xx_hal.h"
 #include <stdarg.h>
+#include <stdbool.h>
 
 #define BT401_BUFFER_SIZE 128
 
@@ -12,6 +14,16 @@
 //     BT401_ERROR = 0x02U
 // } BT401_Status;
 
+// 发送统计
+typedef struct
+{
+    uint32_t bytes_queued;    // 已入队字节数
+    uint32_t bytes_sent;      // DMA已发送完成字节数
+    uint32_t bytes_dropped;   // 队列满被拒绝的字节数
+    uint32_t dma_transfers;   // 启动的DMA传输次数
+    uint64_t cpu_cycles;      // 发送路径（入队与发送完成中断）占用的CPU周期
+} BT401_TxStats;
+
 void HAL_UART_TxCpltCallback(UART_HandleTypeDef* huart);
 void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef* huart, uint16_t Size);
 
@@ -19,8 +31,11 @@ void     BT401_Init(void);
 uint16_t BT401_Read(uint8_t* buffer, uint16_t size);
 uint16_t BT401_Write(uint8_t* buffer, uint16_t size);
 uint16_t BT401_Printf(const char* format, ...);
+bool     BT401_TxBusy(void);
+uint16_t BT401_TxFree(void);
+void     BT401_GetTxStats(BT401_TxStats* stats);
 
-#define AT_PRINTF BT401_Printf
+#define AT_PRINTF at_printf   // AT指令统一经AT引擎排队发送
 #define DEBUG_PRINTF BT401_Printf
 #define AT_TIMEOUT 50   // AT指令超时时间
 #define CMD_TIMEOUT_MS 50
@@ -1,68 +1,151 @@
+#include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 #include "main.h"
 #include "flash.h"
 
-FlashStatus flash_write(uint32_t addr, const uint8_t *buffer, uint32_t bufferLen)
+#if RAMFUNC_ENABLE
+/*
+ * 擦写期间 Flash 无法取指，CPU 在SRAM中执行下面的例程；
+ * 处理函数仍在 Flash 中的中断先屏蔽，只保留SRAM中的 TIM3（SysTick 不受 NVIC 屏蔽），操作结束后挂起的中断再依次响应。
+ * 例程内不能调用任何位于 Flash 的函数。
+ */
+#define FLASH_IRQ_KEEP_MASK (1u << TIM3_IRQn)   // TIM3_IRQn < 32，位于 ISER[0]
+
+RAMFUNC static void _irq_mask(uint32_t saved[2])
 {
-    // 检查地址对齐
-    if ((addr % 2) != 0)
+    saved[0]      = NVIC->ISER[0];
+    saved[1]      = NVIC->ISER[1];
+    NVIC->ICER[0] = saved[0] & ~FLASH_IRQ_KEEP_MASK;
+    NVIC->ICER[1] = saved[1];
+    __DSB();
+    __ISB();
+}
+
+RAMFUNC static void _irq_restore(const uint32_t saved[2])
+{
+    NVIC->ISER[0] = saved[0];
+    NVIC->ISER[1] = saved[1];
+}
+
+RAMFUNC static bool _ram_erase_page(uint32_t addr)
+{
+    uint32_t saved[2];
+    _irq_mask(saved);
+
+    FLASH->CR |= FLASH_CR_PER;
+    FLASH->AR = addr;
+    FLASH->CR |= FLASH_CR_STRT;
+    while (FLASH->SR & FLASH_SR_BSY)
+    {
+    }
+    FLASH->CR &= ~FLASH_CR_PER;
+
+    _irq_restore(saved);
+    return (FLASH->SR & (FLASH_SR_PGERR | FLASH_SR_WRPRTERR)) == 0;
+}
+
+RAMFUNC static bool _ram_program_halfword(uint32_t addr, uint16_t data)
+{
+    uint32_t saved[2];
+    _irq_mask(saved);
+
+    FLASH->CR |= FLASH_CR_PG;
+    *(volatile uint16_t *)addr = data;
+    while (FLASH->SR & FLASH_SR_BSY)
     {
-        return FLASH_ADDR_ALIGN_ERR;
     }
+    FLASH->CR &= ~FLASH_CR_PG;
 
-    // 计算擦除页
-    uint32_t start_page_addr = addr & FLASH_ERASE_ADDR_MASK;
-    uint32_t end_addr = addr + bufferLen;
-    uint32_t end_page_addr = (end_addr - 1) & FLASH_ERASE_ADDR_MASK;
-    uint32_t pages_to_erase = ((end_page_addr - start_page_addr) / FLASH_ERASE_SIZE) + 1;
+    _irq_restore(saved);
+    return (FLASH->SR & (FLASH_SR_PGERR | FLASH_SR_WRPRTERR)) == 0 && *(volatile uint16_t *)addr == data;
+}
+#endif
 
-    // 擦除配置
+FlashStatus flash_erase_page(uint32_t addr)
+{
+#if RAMFUNC_ENABLE
+    HAL_FLASH_Unlock();
+    __HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_EOP | FLASH_FLAG_PGERR | FLASH_FLAG_WRPERR);
+    bool ok = _ram_erase_page(addr & FLASH_ERASE_ADDR_MASK);
+    HAL_FLASH_Lock();
+    return ok ? FLASH_OK : FLASH_ERASE_ERR;
+#else
     FLASH_EraseInitTypeDef EraseInitStruct = {
         .TypeErase = FLASH_TYPEERASE_PAGES,
-        .PageAddress = start_page_addr,
-        .NbPages = pages_to_erase};
+        .PageAddress = addr & FLASH_ERASE_ADDR_MASK,
+        .NbPages = 1};
     uint32_t PageError;
 
-    // 解锁并擦除
     HAL_FLASH_Unlock();
     __HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_EOP | FLASH_FLAG_PGERR | FLASH_FLAG_WRPERR);
-    if (HAL_FLASHEx_Erase(&EraseInitStruct, &PageError) != HAL_OK)
+    HAL_StatusTypeDef status = HAL_FLASHEx_Erase(&EraseInitStruct, &PageError);
+    HAL_FLASH_Lock();
+    return (status == HAL_OK) ? FLASH_OK : FLASH_ERASE_ERR;
+#endif
+}
+
+FlashStatus flash_program(uint32_t addr, const uint8_t *buffer, uint32_t bufferLen)
+{
+    // 检查地址对齐
+    if ((addr % 2) != 0)
     {
-        HAL_FLASH_Lock();
-        return FLASH_ERASE_ERR;
+        return FLASH_ADDR_ALIGN_ERR;
     }
 
-    // 写入数据
-    uint32_t cnt = 0;
-    while (cnt < bufferLen)
+    HAL_FLASH_Unlock();
+    __HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_EOP | FLASH_FLAG_PGERR | FLASH_FLAG_WRPERR);
+
+    // 按半字写入，目标区域必须已擦除
+    for (uint32_t cnt = 0; cnt < bufferLen; cnt += 2)
     {
         uint16_t data;
         if (cnt + 1 < bufferLen)
         {
-            data = *((uint16_t *)(buffer + cnt));
+            data = buffer[cnt] | (buffer[cnt + 1] << 8);
         }
         else
         {
             data = 0xFF00 | buffer[cnt]; // 显式补0xFF
         }
 
+#if RAMFUNC_ENABLE
+        if (!_ram_program_halfword(addr + cnt, data))
+#else
         if (HAL_FLASH_Program(FLASH_TYPEPROGRAM_HALFWORD, addr + cnt, data) != HAL_OK)
+#endif
         {
             HAL_FLASH_Lock();
             return FLASH_WRITE_ERR;
         }
-        cnt += 2;
-
-        // 防止极端情况下越界
-        if (cnt >= bufferLen)
-            break;
     }
 
     HAL_FLASH_Lock();
     return FLASH_OK;
 }
+
+FlashStatus flash_write(uint32_t addr, const uint8_t *buffer, uint32_t bufferLen)
+{
+    // 检查地址对齐
+    if ((addr % 2) != 0)
+    {
+        return FLASH_ADDR_ALIGN_ERR;
+    }
+
+    // 擦除涉及的所有页
+    uint32_t end_page_addr = (addr + bufferLen - 1) & FLASH_ERASE_ADDR_MASK;
+    for (uint32_t page = addr & FLASH_ERASE_ADDR_MASK; page <= end_page_addr; page += FLASH_ERASE_SIZE)
+    {
+        if (flash_erase_page(page) != FLASH_OK)
+        {
+            return FLASH_ERASE_ERR;
+        }
+    }
+
+    return flash_program(addr, buffer, bufferLen);
+}
+
 void flash_read(uint32_t addr, uint8_t *buffer, uint32_t bufferLen)
 {
     memcpy(buffer, (const void *)addr, bufferLen);
@@ -10,8 +10,10 @@
 
 #include <stdint.h>
 
-#define FLASH_START_ADDR      (0x08000000 + 50 * 1024)      // 48KB起始地址
-#define FLASH_ALARM_ADDR      (FLASH_START_ADDR + 1 * 1024) // 确保不覆盖代码区
+#define FLASH_START_ADDR      (0x08000000 + 50 * 1024)      // 50KB起始地址，程序区须小于50KB（uvprojx、eide.yml、sct）
+#define FLASH_ALARM_ADDR      (FLASH_START_ADDR + 1 * 1024) // 旧版闹钟镜像，仅用于升级时迁移
+#define FLASH_KV_ADDR         (FLASH_START_ADDR + 2 * 1024) // 键值存储区起始地址
+#define FLASH_KV_PAGES        (4)                           // 键值存储区页数
 #define FLASH_ERASE_SIZE      (1024)                        // STM32F103页大小为1KB
 #define FLASH_ERASE_ADDR_MASK (~(FLASH_ERASE_SIZE - 1))
 
@@ -23,6 +25,10 @@ typedef enum {
     FLASH_ADDR_ALIGN_ERR
 } FlashStatus;
 
+FlashStatus flash_erase_page(uint32_t addr);
+// 只编程不擦除，目标区域必须已擦除
+FlashStatus flash_program(uint32_t addr, const uint8_t *buffer, uint32_t bufferLen);
+// 擦除涉及的页后写入
 FlashStatus flash_write(uint32_t addr, const uint8_t *buffer, uint32_t bufferLen);
 void flash_read(uint32_t addr, uint8_t *buffer, uint32_t bufferLen);
 
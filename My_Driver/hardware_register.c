@@ -1,5 +1,6 @@
 #include "hardware_register.h"
 #include "alarm.h"
+#include "at_cmd.h"
 #include "beep.h"
 #include "bt401.h"
 #include "flash.h"
@@ -9,6 +10,7 @@
 #include "mytime.h"
 #include "ntc.h"
 #include "pid.h"
+#include "protocol.h"
 #include "register_interface.h"
 #include "rtc.h"
 #include "shortcut.h"
@@ -97,28 +99,6 @@ void stop_music_task(void)
     mode_control(NONE_MODE);
 }
 
-// 去除0x00字符
-static void remove_out_0x00_dat(char* in_buff, int data_len)
-{
-    int str_len = 0;
-    for (int i = 0; i < data_len; i++)
-        if (in_buff[i] != 0x00) in_buff[str_len++] = in_buff[i];
-    in_buff[str_len] = '\0';
-}
-
-// 发送命令并读取响应
-static bool send_command_and_read_response(const char* cmd, uint32_t timeout_ms, char* resp_buffer, size_t buffer_size)
-{
-    if (!cmd || !resp_buffer || buffer_size == 0) return false;
-    BT401_Printf("%s\r\n", cmd);
-    HAL_Delay(timeout_ms);
-    uint16_t bytes_read = BT401_Read((uint8_t*)resp_buffer, buffer_size - 1);
-    if (bytes_read == 0) return false;
-    remove_out_0x00_dat(resp_buffer, bytes_read);
-    resp_buffer[bytes_read] = '\0';
-    return true;
-}
-
 // 解析带前缀的数值响应
 static bool parse_value_from_response(const char* response, const char* prefix, uint8_t* value, uint8_t default_value)
 {
@@ -140,42 +120,75 @@ static bool parse_value_from_response(const char* response, const char* prefix,
     return true;
 }
 
-// 发送AT命令
+// 发送AT命令（异步入队，返回是否入队成功，应答由AT引擎处理）
 bool send_at_command(const char* cmd, uint32_t timeout_ms)
 {
-    char resp_buffer[64] = {0};
-    if (!send_command_and_read_response(cmd, timeout_ms, resp_buffer, sizeof(resp_buffer))) return false;
-    if (strstr(resp_buffer, "ER")) return false;
-    return strstr(resp_buffer, "OK") != NULL;
+    return at_send(cmd, timeout_ms, NULL, NULL);
 }
 
-// 查询BLE状态
+static uint8_t ble_status      = BLE_STATUS_DEFAULT;
+static bool ble_status_pending = false;   // 已有查询在队列中，避免重复入队
+
+static void ble_status_done(AT_Result result, const char* response, void* arg)
+{
+    bool was_connected = (ble_status != 0);
+    if (result == AT_RESULT_OK) parse_value_from_response(response, "TS+", &ble_status, BLE_STATUS_DEFAULT);
+    ble_status_pending = false;
+    if ((ble_status != 0) != was_connected) protocol_reset_session();   // 连接建立或断开，协议会话重新开始
+}
+
+// 查询BLE状态：发起异步查询，返回上一次查询结果
 int query_ble_status(void)
 {
-    static uint8_t ble_status          = BLE_STATUS_DEFAULT;
-    char resp_buffer[MAX_RESPONSE_LEN] = {0};
-    if (send_command_and_read_response("AT+TS", CMD_TIMEOUT_MS, resp_buffer, sizeof(resp_buffer)))
-        parse_value_from_response(resp_buffer, "TS+", &ble_status, BLE_STATUS_DEFAULT);
+    if (!ble_status_pending)
+        ble_status_pending = at_query("AT+TS", "TS+", CMD_TIMEOUT_MS, ble_status_done, NULL);
     return ble_status;
 }
 
+// 单值查询：应答中 prefix 之后的十进制数，失败时为 default_value
+typedef struct
+{
+    const char* prefix;
+    uint8_t default_value;
+    QueryCallback callback;
+    void* arg;
+    bool used;
+} QueryRequest;
+
+static QueryRequest query_requests[QUERY_SLOTS];
+
+static void query_value_done(AT_Result result, const char* response, void* arg)
+{
+    QueryRequest* query = (QueryRequest*)arg;
+    uint8_t value       = query->default_value;
+    if (result == AT_RESULT_OK) parse_value_from_response(response, query->prefix, &value, query->default_value);
+    query->used = false;   // 先释放，回调中可以再次查询
+    query->callback(value, query->arg);
+}
+
+static bool query_value(const char* cmd, const char* prefix, uint8_t default_value, QueryCallback callback, void* arg)
+{
+    for (uint8_t i = 0; i < QUERY_SLOTS; i++)
+    {
+        QueryRequest* query = &query_requests[i];
+        if (query->used) continue;
+
+        *query = (QueryRequest){prefix, default_value, callback, arg, true};
+        if (at_query(cmd, prefix, CMD_TIMEOUT_MS, query_value_done, query)) return true;
+        query->used = false;
+        return false;
+    }
+    return false;
+}
+
 // 查询BLE连接模式
-uint8_t query_ble_cm(void)
+bool query_ble_cm(QueryCallback callback, void* arg)
 {
-    uint8_t ble_cm                     = 0;
-    char resp_buffer[MAX_RESPONSE_LEN] = {0};
-    if (send_command_and_read_response("AT+QM", CMD_TIMEOUT_MS, resp_buffer, sizeof(resp_buffer)))
-        parse_value_from_response(resp_buffer, "QM+", &ble_cm, 0);
-    return ble_cm;
+    return query_value("AT+QM", "QM+", 0, callback, arg);
 }
 
 // 查询音乐ID
-uint8_t query_music_id(void)
-{
-    uint8_t music_id                   = MUSIC_ID_DEFAULT;
-    char resp_buffer[MAX_RESPONSE_LEN] = {0};
-    if (send_command_and_read_response("AT+M1", CMD_TIMEOUT_MS, resp_buffer, sizeof(resp_buffer)))
-        parse_value_from_response(resp_buffer, "M1+", &music_id, MUSIC_ID_DEFAULT);
-    // DEBUG_PRINTF("MusicID: %d\n", music_id);
-    return music_id;
+bool query_music_id(QueryCallback callback, void* arg)
+{
+    return query_value("AT+M1", "M1+", MUSIC_ID_DEFAULT, callback, arg);
 }
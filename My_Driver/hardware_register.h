@@ -7,6 +7,9 @@
 #define MAX_RESPONSE_LEN 128
 #define BLE_STATUS_DEFAULT 0
 #define MUSIC_ID_DEFAULT 0
+#define QUERY_SLOTS 4   // 同时等待应答的单值查询数
+
+typedef void (*QueryCallback)(uint8_t value, void* arg);
 
 uint32_t get_remaining_seconds(void);
 void set_remaining_seconds(uint32_t seconds);
@@ -29,7 +32,8 @@ void stop_music_task(void);
 bool send_at_command(const char* cmd, uint32_t timeout_ms);
 
 int query_ble_status(void);
-uint8_t query_ble_cm(void);
-uint8_t query_music_id(void);
+// 异步查询：入队成功返回true，应答或超时后在AT引擎任务中回调，失败时 value 为默认值
+bool query_ble_cm(QueryCallback callback, void* arg);
+bool query_music_id(QueryCallback callback, void* arg);
 
 #endif   // HARDWARE_REGISTER_H
@@ -6,6 +6,7 @@
 #include "led.h"
 #include "main.h"
 #include "ntc.h"
+#include "persist.h"
 #include "register_interface.h"
 #include "shortcut.h"
 #include <stdio.h>
@@ -204,7 +205,7 @@ static void set_heating_timer(unsigned char key)
 void shutdown()
 {
     // save_config();   // 保存配置
-    save_alarms();   // 保存闹钟
+    persist_flush();   // 同步写入尚未保存的闹钟和配置
     HAL_PWR_EnterSTANDBYMode();
     HAL_GPIO_WritePin(POWER_GPIO_Port, POWER_Pin, GPIO_PIN_RESET);
 }
@@ -0,0 +1,221 @@
+#include "kv_store.h"
+#include "crc16.h"
+#include <stdbool.h>
+#include <string.h>
+
+#define KV_PAGE_MAGIC 0x4B56    // 页头标识 "KV"
+#define KV_PAGE_HEADER_SIZE 4   // 页头：[标识(2)][页序号(2)]
+#define KV_RECORD_OVERHEAD 4    // 记录头(2) + CRC(2)
+#define KV_ERASED 0xFFFF        // 擦除后的半字
+#define KV_PAGE_SIZE FLASH_ERASE_SIZE
+
+static uint16_t _Index[KV_KEY_COUNT];          // 每个键最新记录相对 FLASH_KV_ADDR 的偏移，0 表示不存在
+static uint8_t _ActivePage   = 0;              // 正在追加记录的页
+static uint16_t _ActiveSeq   = 0;              // 当前页序号，每换一页加1
+static uint16_t _WriteOffset = KV_PAGE_SIZE;   // 当前页内下一条记录的偏移
+
+static uint32_t _page_addr(uint8_t page)
+{
+    return FLASH_KV_ADDR + (uint32_t)page * KV_PAGE_SIZE;
+}
+
+static uint16_t _read_u16(uint32_t addr)
+{
+    uint16_t value;
+    flash_read(addr, (uint8_t*)&value, sizeof(value));
+    return value;
+}
+
+static uint16_t _record_size(uint8_t len)
+{
+    return KV_RECORD_OVERHEAD + ((len + 1u) & ~1u);
+}
+
+static uint16_t _record_crc(uint8_t key, uint8_t len, const uint8_t* value)
+{
+    uint8_t head[2] = {key, len};
+    return crc16_final(crc16_update(crc16_update(crc16_init(), head, sizeof(head)), value, len));
+}
+
+static bool _page_valid(uint8_t page)
+{
+    return _read_u16(_page_addr(page)) == KV_PAGE_MAGIC;
+}
+
+static bool _page_blank(uint8_t page)
+{
+    const uint32_t* word = (const uint32_t*)_page_addr(page);
+    for (uint16_t i = 0; i < KV_PAGE_SIZE / sizeof(uint32_t); i++)
+    {
+        if (word[i] != 0xFFFFFFFF) return false;
+    }
+    return true;
+}
+
+// 遍历页内校验正确的记录并更新索引（后写入的覆盖先写入的），返回页内第一个空闲位置
+// 记录头损坏时无法确定后续记录位置，返回页大小使该页不再追加
+static uint16_t _scan_page(uint8_t page)
+{
+    uint32_t base = _page_addr(page);
+    uint16_t pos  = KV_PAGE_HEADER_SIZE;
+
+    while (pos + KV_RECORD_OVERHEAD <= KV_PAGE_SIZE)
+    {
+        uint16_t head = _read_u16(base + pos);
+        if (head == KV_ERASED) return pos;
+
+        uint8_t key = head & 0xFF;
+        uint8_t len = head >> 8;
+        if (key >= KV_KEY_COUNT || len > KV_MAX_VALUE_LEN || pos + _record_size(len) > KV_PAGE_SIZE) break;
+
+        // 写入中途掉电的记录校验失败，跳过
+        if (_read_u16(base + pos + _record_size(len) - 2) == _record_crc(key, len, (const uint8_t*)(base + pos + 2)))
+        {
+            _Index[key] = (uint16_t)(page * KV_PAGE_SIZE + pos);
+        }
+        pos += _record_size(len);
+    }
+    return KV_PAGE_SIZE;
+}
+
+// 在当前页末尾追加记录，调用前须确认剩余空间足够
+static FlashStatus _append(uint8_t key, const uint8_t* value, uint8_t len)
+{
+    uint8_t record[KV_RECORD_OVERHEAD + KV_MAX_VALUE_LEN];
+    uint16_t size = _record_size(len);
+    uint16_t crc  = _record_crc(key, len, value);
+
+    record[0] = key;
+    record[1] = len;
+    memcpy(&record[2], value, len);
+    record[2 + len]  = 0xFF;   // 奇数长度的补齐字节
+    record[size - 2] = crc & 0xFF;
+    record[size - 1] = crc >> 8;
+
+    uint16_t offset    = _WriteOffset;
+    FlashStatus status = flash_program(_page_addr(_ActivePage) + offset, record, size);
+    _WriteOffset += size;   // 写失败的区域也跳过，不再重复编程
+    if (status == FLASH_OK) _Index[key] = (uint16_t)(_ActivePage * KV_PAGE_SIZE + offset);
+    return status;
+}
+
+static FlashStatus _start_page(uint8_t page, uint16_t seq)
+{
+    uint8_t header[KV_PAGE_HEADER_SIZE] = {KV_PAGE_MAGIC & 0xFF, KV_PAGE_MAGIC >> 8, seq & 0xFF, seq >> 8};
+
+    _ActivePage  = page;
+    _ActiveSeq   = seq;
+    _WriteOffset = KV_PAGE_SIZE;   // 页头写入失败时该页不可用
+    if (flash_program(_page_addr(page), header, sizeof(header)) != FLASH_OK) return FLASH_WRITE_ERR;
+    _WriteOffset = KV_PAGE_HEADER_SIZE;
+    return FLASH_OK;
+}
+
+// 回收一页：把最新记录仍在该页的键搬到当前页，然后擦除该页
+static FlashStatus _collect(uint8_t page)
+{
+    uint16_t start = page * KV_PAGE_SIZE;
+
+    for (uint8_t key = 0; key < KV_KEY_COUNT; key++)
+    {
+        if (_Index[key] < start || _Index[key] >= start + KV_PAGE_SIZE) continue;
+
+        uint32_t addr = FLASH_KV_ADDR + _Index[key];
+        uint8_t len   = _read_u16(addr) >> 8;
+        if (_WriteOffset + _record_size(len) > KV_PAGE_SIZE) return FLASH_WRITE_ERR;
+        if (_append(key, (const uint8_t*)(addr + 2), len) != FLASH_OK) return FLASH_WRITE_ERR;
+    }
+
+    if (_page_blank(page)) return FLASH_OK;
+    return flash_erase_page(_page_addr(page));
+}
+
+// 当前页写满：换到下一页（空闲页），再回收最旧的一页作为新的空闲页
+static FlashStatus _rotate(void)
+{
+    uint8_t next = (_ActivePage + 1) % FLASH_KV_PAGES;
+    if (!_page_blank(next) && flash_erase_page(_page_addr(next)) != FLASH_OK) return FLASH_ERASE_ERR;
+    if (_start_page(next, _ActiveSeq + 1) != FLASH_OK) return FLASH_WRITE_ERR;
+    return _collect((next + 1) % FLASH_KV_PAGES);
+}
+
+static void _format(void)
+{
+    memset(_Index, 0, sizeof(_Index));
+    for (uint8_t page = 0; page < FLASH_KV_PAGES; page++)
+    {
+        if (!_page_blank(page)) flash_erase_page(_page_addr(page));
+    }
+    _start_page(0, 0);
+}
+
+void kv_init(void)
+{
+    bool found = false;
+
+    // 序号最新的有效页为当前页
+    for (uint8_t page = 0; page < FLASH_KV_PAGES; page++)
+    {
+        if (!_page_valid(page)) continue;
+
+        uint16_t seq = _read_u16(_page_addr(page) + 2);
+        if (!found || (int16_t)(seq - _ActiveSeq) > 0)
+        {
+            _ActivePage = page;
+            _ActiveSeq  = seq;
+            found       = true;
+        }
+    }
+    if (!found)
+    {
+        _format();
+        return;
+    }
+
+    // 各页按环形顺序使用，从当前页的下一页（最旧）扫描到当前页，后写入的记录覆盖先写入的
+    memset(_Index, 0, sizeof(_Index));
+    for (uint8_t i = 1; i <= FLASH_KV_PAGES; i++)
+    {
+        uint8_t page = (_ActivePage + i) % FLASH_KV_PAGES;
+        if (!_page_valid(page)) continue;
+
+        uint16_t end = _scan_page(page);
+        if (page == _ActivePage) _WriteOffset = end;
+    }
+
+    // 换页后回收最旧页的过程中掉电：当前页的下一页应为空闲页，在此完成回收
+    uint8_t spare = (_ActivePage + 1) % FLASH_KV_PAGES;
+    if (!_page_blank(spare) && _collect(spare) != FLASH_OK)
+    {
+        _format();
+    }
+}
+
+uint8_t kv_read(KvKey key, void* buffer, uint8_t size)
+{
+    if (key >= KV_KEY_COUNT || _Index[key] == 0) return 0;
+
+    uint32_t addr = FLASH_KV_ADDR + _Index[key];
+    uint8_t len   = _read_u16(addr) >> 8;
+    flash_read(addr + 2, (uint8_t*)buffer, (len < size) ? len : size);
+    return len;
+}
+
+FlashStatus kv_write(KvKey key, const void* data, uint8_t len)
+{
+    if (key >= KV_KEY_COUNT || len > KV_MAX_VALUE_LEN) return FLASH_WRITE_ERR;
+
+    // 值未改变时不写入，减少擦写次数
+    if (_Index[key] != 0)
+    {
+        uint32_t addr = FLASH_KV_ADDR + _Index[key];
+        if ((_read_u16(addr) >> 8) == len && memcmp((const void*)(addr + 2), data, len) == 0) return FLASH_OK;
+    }
+
+    // 每次换页都会回收一页，有效记录总量不超过一页，有限次换页后必然有空间
+    for (uint8_t i = 0; _WriteOffset + _record_size(len) > KV_PAGE_SIZE; i++)
+    {
+        if (i == FLASH_KV_PAGES || _rotate() != FLASH_OK) return FLASH_WRITE_ERR;
+    }
+    return _append(key, (const uint8_t*)data, len);
+}
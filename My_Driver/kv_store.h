@@ -0,0 +1,33 @@
+#ifndef __KV_STORE_H
+#define __KV_STORE_H
+
+#include "flash.h"
+#include <stdint.h>
+
+/*
+ * 日志结构的键值存储，占用 FLASH_KV_PAGES 页。
+ * - 每次保存只在当前页末尾追加一条记录（几次半字编程），不擦除；值未改变时不写入。
+ * - 记录格式：[键(1)][长度(1)][值(n，补齐到偶数)][CRC(2)]，读取时取每个键最新且校验正确的记录。
+ * - 当前页写满后切换到下一页（始终保持一页空闲），并把最旧页中仍有效的记录搬过来后擦除该页，
+ *   各页轮流擦写实现磨损均衡。
+ */
+#define KV_MAX_VALUE_LEN 32   // 单条记录值的最大长度，所有键的最大记录之和须小于一页，回收时才能全部搬入新页
+#define KV_ALARM_KEYS 10      // 闹钟键数量，与 MAX_ALARMS 一致
+
+typedef enum
+{
+    KV_KEY_CONFIG = 0,   // 寄存器配置
+    KV_KEY_ALARM_BASE,   // 闹钟，每个闹钟一个键
+    // 加热器整定结果
+    KV_KEY_TUNING = KV_KEY_ALARM_BASE + KV_ALARM_KEYS,
+    KV_KEY_COUNT,
+} KvKey;
+
+// 挂载存储区，须在读写之前调用；存储区无效时格式化
+void kv_init(void);
+// 读取键的最新值，返回已保存的值长度（0 表示不存在），最多拷贝 size 字节
+uint8_t kv_read(KvKey key, void* buffer, uint8_t size);
+// 追加一条记录，值与当前相同时直接返回 FLASH_OK
+FlashStatus kv_write(KvKey key, const void* data, uint8_t len);
+
+#endif   // __KV_STORE_H
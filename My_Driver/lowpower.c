@@ -0,0 +1,60 @@
+#include "lowpower.h"
+#include "bt401.h"
+#include "hardware_register.h"
+#include "main.h"
+#include "mytime.h"
+#include "rtc.h"
+
+extern volatile uint64_t platform_ticks;   // 平台滴答计数器（main.c）
+
+void lowpower_init(void)
+{
+#if LOWPOWER_USE_STOP
+    HAL_NVIC_SetPriority(RTC_Alarm_IRQn, 0, 0);
+    HAL_NVIC_EnableIRQ(RTC_Alarm_IRQn);
+#endif
+}
+
+#if LOWPOWER_USE_STOP
+// 进入STOP模式，由RTC闹钟在截止时间之前唤醒；返回false表示时间不足一个RTC秒，未进入
+static bool lowpower_enter_stop(int ticks_to_next)
+{
+    uint64_t start_ms = read_rtc_ms();
+    uint32_t alarm    = (uint32_t)((start_ms + (uint32_t)ticks_to_next) / 1000U);   // 不晚于截止时间的整秒
+    if (alarm <= (uint32_t)(start_ms / 1000U)) return false;
+    if (write_rtc_alarm(alarm) != HAL_OK) return false;
+
+    HAL_SuspendTick();
+    HAL_PWR_EnterSTOPMode(PWR_LOWPOWERREGULATOR_ON, PWR_STOPENTRY_WFI);
+    SystemClock_Config();   // STOP唤醒后系统时钟为HSI，重新配置PLL
+    HAL_ResumeTick();
+
+    // STOP期间TIM3与SysTick停止，按RTC经过时间补偿
+    uint32_t elapsed_ms = (uint32_t)(read_rtc_ms() - start_ms);
+    __disable_irq();
+    platform_ticks += elapsed_ms;
+    uwTick += elapsed_ms;
+    __enable_irq();
+    return true;
+}
+#endif
+
+void lowpower_idle(uint64_t yield_tick, int ticks_to_next)
+{
+    if (ticks_to_next <= 0) return;   // 有到期任务（或无定时器）时不休眠
+
+#if LOWPOWER_USE_STOP
+    if (ticks_to_next >= LOWPOWER_STOP_MIN_TICKS && !is_heating_active() && !is_music_active() && !BT401_TxBusy())
+    {
+        if (lowpower_enter_stop(ticks_to_next)) return;
+    }
+#endif
+
+    // 关中断后再检查，避免检查与WFI之间到来的滴答被错过；挂起的中断仍会唤醒WFI
+    __disable_irq();
+    if (platform_ticks < yield_tick + (uint32_t)ticks_to_next)
+    {
+        __WFI();
+    }
+    __enable_irq();
+}
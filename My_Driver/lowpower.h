@@ -0,0 +1,21 @@
+#ifndef __LOWPOWER_H
+#define __LOWPOWER_H
+
+#include "stm32f1xx_hal.h"
+
+/*
+ * 空闲低功耗：主循环在 multiTimerYield() 之后调用 lowpower_idle()。
+ * - 默认进入 SLEEP（WFI），外设与 TIM3 照常运行，任一中断（1ms 滴答、串口、DMA）唤醒，无需补偿滴答。
+ * - LOWPOWER_USE_STOP 为 1 时，若下一截止时间不少于 LOWPOWER_STOP_MIN_TICKS 且当前没有加热/音乐任务，
+ *   进入 STOP 模式并由 RTC 闹钟唤醒，醒来后根据 RTC 经过时间补偿 platform_ticks 和 HAL 滴答。
+ *   STOP 期间 USART3 无法接收数据，且 1ms 刷新任务常驻时不会满足条件，因此默认关闭。
+ */
+#ifndef LOWPOWER_USE_STOP
+#    define LOWPOWER_USE_STOP 0
+#endif
+#define LOWPOWER_STOP_MIN_TICKS 2000   // 距离下一截止时间至少2s才值得进入STOP
+
+void lowpower_init(void);
+void lowpower_idle(uint64_t yield_tick, int ticks_to_next);
+
+#endif   // __LOWPOWER_H
@@ -0,0 +1,61 @@
+#include "median.h"
+
+// 有序窗口 [0, count) 中第一个不小于 value 的位置
+static uint16_t _lower_bound(const uint16_t* sorted, uint16_t count, uint16_t value)
+{
+    uint16_t low = 0, high = count;
+    while (low < high)
+    {
+        uint16_t mid = (low + high) / 2;
+        if (sorted[mid] < value)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    return low;
+}
+
+void median_init(MedianFilter* filter, uint16_t* window, uint16_t* sorted, uint16_t size)
+{
+    filter->window = window;
+    filter->sorted = sorted;
+    filter->size   = size;
+    filter->count  = 0;
+    filter->head   = 0;
+}
+
+void median_push(MedianFilter* filter, uint16_t sample)
+{
+    uint16_t* sorted = filter->sorted;
+    uint16_t hole;   // 有序窗口中的空位
+
+    if (filter->count == filter->size)
+    {
+        hole = _lower_bound(sorted, filter->count, filter->window[filter->head]);   // 移除最旧样本
+    } else
+    {
+        hole = filter->count++;   // 窗口未满：空位在末尾
+    }
+
+    // 空位向新样本应在的位置移动，保持升序
+    while (hole > 0 && sorted[hole - 1] > sample)
+    {
+        sorted[hole] = sorted[hole - 1];
+        hole--;
+    }
+    while (hole + 1 < filter->count && sorted[hole + 1] < sample)
+    {
+        sorted[hole] = sorted[hole + 1];
+        hole++;
+    }
+    sorted[hole] = sample;
+
+    filter->window[filter->head] = sample;
+    filter->head                 = (filter->head + 1) % filter->size;
+}
+
+uint16_t median_get(const MedianFilter* filter)
+{
+    if (filter->count == 0) return 0;
+    return filter->sorted[filter->count / 2];
+}
@@ -0,0 +1,34 @@
+#ifndef __MEDIAN_H
+#define __MEDIAN_H
+
+#include <stdint.h>
+
+/*
+ * 滑动窗口中位数滤波。
+ * - 除按到达顺序保存的环形窗口外，另存一份有序窗口；每来一个样本，二分查找最旧样本在有序窗口中的位置，
+ *   把空位移动到新样本应在的位置后写入，只移动两者之间的元素，不排序、不分配内存，每个样本最坏 O(n)。
+ * - 读取中位数只是一次数组访问，但 median_push 会移动 sorted 中的元素：在中断中入队、主循环读取时须关中断
+ *   （见 ntc.c 的 Get_Filtered_Temperature），否则可能读到移动到一半的有序窗口。
+ * - 窗口长度由调用者提供的缓冲区决定，可以到几百个样本；入队平均移动的元素数约为窗口长度的三分之一。
+ * - 没有另做小窗口的排序网络和大窗口的双堆：9 输入排序网络每次求值比入队快（主机上约 3ns 对 60ns），
+ *   但只适用于固定长度的满窗口，上电后窗口未满时仍要另一条路径；双堆删除最旧样本需要每个样本的堆内位置索引。
+ *   NTC 每秒只有 16 个抽取值，两者的差别可以忽略。tests/test_median.c 与复制加 qsort 逐样本比较，
+ *   并给出 9~301 个样本窗口的每样本开销。
+ */
+typedef struct
+{
+    uint16_t* window;   // 按到达顺序的样本，长度 size
+    uint16_t* sorted;   // 升序排列的样本，长度 size
+    uint16_t size;      // 窗口长度
+    uint16_t count;     // 已有样本数，窗口未满时小于 size
+    uint16_t head;      // window 中下一个写入位置（窗口满时即最旧样本）
+} MedianFilter;
+
+// window、sorted 为调用者提供的缓冲区，各 size 个元素
+void median_init(MedianFilter* filter, uint16_t* window, uint16_t* sorted, uint16_t size);
+// 加入一个样本，窗口已满时替换最旧的样本
+void median_push(MedianFilter* filter, uint16_t sample);
+// 当前窗口的中位数（偶数个样本时取较大的一个），没有样本时返回0
+uint16_t median_get(const MedianFilter* filter);
+
+#endif   // __MEDIAN_H
@@ -177,6 +177,58 @@ uint32_t read_utc(void)
 {
     return RTC_ReadTimeCounter(&hrtc);
 }
+
+/**
+ * @brief  读取带亚秒精度的RTC时间（毫秒），用于低功耗唤醒后补偿滴答计数
+ * @retval RTC_CNT * 1000 + 当前秒内已经过的毫秒数
+ */
+uint64_t read_rtc_ms(void)
+{
+    uint32_t counter, divider;
+    uint32_t rtc_hz = HAL_RCCEx_GetPeriphCLKFreq(RCC_PERIPHCLK_RTC);
+
+    /* DIV与CNT不能原子读取，CNT变化时重读 */
+    do
+    {
+        counter = RTC_ReadTimeCounter(&hrtc);
+        divider = ((READ_REG(hrtc.Instance->DIVH) & RTC_DIVH_RTC_DIV) << 16U) |
+                  (READ_REG(hrtc.Instance->DIVL) & RTC_DIVL_RTC_DIV);
+    } while (counter != RTC_ReadTimeCounter(&hrtc));
+
+    if (rtc_hz == 0U) return (uint64_t)counter * 1000U;
+    if (divider >= rtc_hz) divider = rtc_hz - 1U;
+
+    /* DIV 每个RTC时钟从 rtc_hz-1 递减到 0 */
+    return (uint64_t)counter * 1000U + (uint64_t)(rtc_hz - 1U - divider) * 1000U / rtc_hz;
+}
+
+/**
+ * @brief  设置RTC闹钟计数值，并使能闹钟中断（EXTI17，可从STOP模式唤醒）
+ * @param  alarm  RTC_CNT 达到该值时触发
+ * @retval HAL status
+ */
+HAL_StatusTypeDef write_rtc_alarm(uint32_t alarm)
+{
+    HAL_StatusTypeDef status = HAL_OK;
+
+    if (RTC_EnterInitMode(&hrtc) != HAL_OK)
+    {
+        return HAL_ERROR;
+    }
+    WRITE_REG(hrtc.Instance->ALRH, (alarm >> 16U));
+    WRITE_REG(hrtc.Instance->ALRL, (alarm & RTC_ALRL_RTC_ALR));
+    if (RTC_ExitInitMode(&hrtc) != HAL_OK)
+    {
+        status = HAL_ERROR;
+    }
+
+    __HAL_RTC_ALARM_CLEAR_FLAG(&hrtc, RTC_FLAG_ALRAF);
+    __HAL_RTC_ALARM_EXTI_CLEAR_FLAG();
+    __HAL_RTC_ALARM_ENABLE_IT(&hrtc, RTC_IT_ALRA);
+    __HAL_RTC_ALARM_EXTI_ENABLE_IT();
+    __HAL_RTC_ALARM_EXTI_ENABLE_RISING_EDGE();
+    return status;
+}
 /**
  * @brief  获取当前时间
  * @retval 当前时间的指针
@@ -27,6 +27,8 @@ void print_current_datetime(void);
 
 HAL_StatusTypeDef write_utc(uint32_t time);
 uint32_t read_utc(void);
+uint64_t read_rtc_ms(void);
+HAL_StatusTypeDef write_rtc_alarm(uint32_t alarm);
 struct tm* XX_RTC_GetTime(void);
 void XX_RTC_Init(void);
 
@@ -1,73 +1,95 @@
 #include "ntc.h"
 #include "adc.h"
+#include "autotune.h"
 #include "bt401.h"
 #include "led.h"
+#include "median.h"
 #include "mytime.h"
+#include "ntc_table.h"
 #include "pid.h"
 #include "register_interface.h"
 #include "tim.h"
 
-#include <math.h>
 #include <stdint.h>
-#include <stdlib.h>
 #include <string.h>
 
-/* 宏定义 */
-#define SAMPLES 10   // ADC采样点数
+/*
+ * ADC 采样：TIM3 更新事件（1kHz）触发单次转换，采样时间 239.5 周期以适应 10kΩ NTC 分压的源阻抗。
+ * DMA 循环写入双缓冲，半满/全满回调中把 ADC_BLOCK_SAMPLES 个采样平均为一个抽取值（每 64ms 一个），
+ * 抽取值在回调中送入滑动中位数滤波器（最近 SAMPLES 个），控温时直接读取中位数，不再复制和排序。
+ */
+#define ADC_BLOCK_SAMPLES 64                      // 每半缓冲的采样数
+#define ADC_DMA_SAMPLES (2 * ADC_BLOCK_SAMPLES)   // DMA双缓冲总长度
+#define SAMPLES 9                                 // 参与中位数滤波的抽取值个数（约0.6s）
 #define CLAMP(x, low, high) (((x) > (high)) ? (high) : (((x) < (low)) ? (low) : (x)))
 #define INVALID_TEMP -128.0f   // 无效温度标识
 
 // 系统状态
 static float current_temperature = INVALID_TEMP;
 static float target_temperature  = 35.0f;
-volatile bool adc_complete       = false;   // ADC采样完成标志
-uint16_t adc_buffer[SAMPLES];               // ADC采样缓冲区
+volatile bool adc_complete       = false;   // 有新的抽取值
+
+// ADC采样缓冲区
+static uint16_t adc_dma_buffer[ADC_DMA_SAMPLES];   // DMA双缓冲
+static uint16_t adc_window[SAMPLES];          // 抽取值，按到达顺序
+static uint16_t adc_window_sorted[SAMPLES];   // 抽取值，升序
+static MedianFilter adc_median;
 
 // 定义PID控制器
 PID_Controller heater_pid;
 static float last_valid_temp = INVALID_TEMP;   // 上一次有效温度
 
-// ADC转换完成回调函数
+// 对半个DMA缓冲求平均，得到一个抽取值
+static void adc_decimate(const uint16_t* block)
+{
+    uint32_t sum = 0;
+    for (uint16_t i = 0; i < ADC_BLOCK_SAMPLES; i++)
+    {
+        sum += block[i];
+    }
+    median_push(&adc_median, (uint16_t)((sum + ADC_BLOCK_SAMPLES / 2) / ADC_BLOCK_SAMPLES));
+    adc_complete = true;
+}
+
+// ADC DMA半满回调：前半缓冲已写满，DMA正在写后半缓冲
+void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef* hadc)
+{
+    if (hadc->Instance == hadc1.Instance)
+    {
+        adc_decimate(&adc_dma_buffer[0]);
+    }
+}
+
+// ADC DMA全满回调：后半缓冲已写满，DMA回到前半缓冲
 void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef* hadc)
 {
     if (hadc->Instance == hadc1.Instance)
     {
-        adc_complete = true;
+        adc_decimate(&adc_dma_buffer[ADC_BLOCK_SAMPLES]);
     }
 }
 
 void Temp_init(void)
 {
-    HAL_ADC_Start_DMA(&hadc1, (uint32_t*)adc_buffer, SAMPLES);
+    HAL_ADCEx_Calibration_Start(&hadc1);                                      // 上电校准，降低偏移误差
+    median_init(&adc_median, adc_window, adc_window_sorted, SAMPLES);
+    HAL_ADC_Start_DMA(&hadc1, (uint32_t*)adc_dma_buffer, ADC_DMA_SAMPLES);   // 由TIM3 TRGO触发转换
     HAL_TIM_PWM_Start(&htim1, TIM_CHANNEL_4);
-    PID_Init(&heater_pid, 10.0f, 0.1f, 4.5f, 50.0f, 0.0f, 100.0f);
-    // PID_Init(&heater_pid, 6.0f, 0.0f, 0.0f, 100.0f, 0.0f, 100.0f);
+    PID_Init(&heater_pid, PID_Q16(10.0f), PID_Q16(0.1f), PID_Q16(4.5f), PID_Q16(50.0f), PID_Q16(0.0f), PID_Q16(100.0f));
+    // PID_Init(&heater_pid, PID_Q16(6.0f), PID_Q16(0.0f), PID_Q16(0.0f), PID_Q16(100.0f), PID_Q16(0.0f), PID_Q16(100.0f));
+    autotune_init(&heater_pid);   // 有自整定结果时替换上面的默认参数
     last_valid_temp = INVALID_TEMP;
 }
 
-// 比较函数用于 qsort
-static int compare_uint16(const void* a, const void* b)
-{
-    uint16_t va = *(const uint16_t*)a;
-    uint16_t vb = *(const uint16_t*)b;
-    return (va > vb) ? 1 : (va < vb) ? -1 : 0;
-}
-
+// 查表得到温度，表覆盖 -20~100℃，超出范围返回 INVALID_TEMP
 static float NTC_temperature(uint16_t adc_value)
 {
-    float B     = 3950.0f;
-    float R2    = 10000.0f;
-    float T2    = 25.0f;
-    float ntc_R = (adc_value / (4095.0f - adc_value)) * 10000.0f;
-
-    if (ntc_R == 0) return 0.0f;   // 防止除零错误
-
-    float T1 = 1.0f / ((log(ntc_R / R2) / B) + (1.0f / (T2 + 273.15f))) - 273.15f;
-    if (T1 < -20.0f || T1 > 100.0f)
+    int16_t temp_q88 = ntc_adc_to_q88(adc_value);
+    if (temp_q88 == NTC_Q88_INVALID)
     {
         return INVALID_TEMP;   // 温度超出范围
     }
-    return T1;
+    return temp_q88 / 256.0f;
 }
 
 // 获取滤波后温度（去掉滑动平均，仅中位数滤波）
@@ -75,12 +97,11 @@ float Get_Filtered_Temperature(void)
 {
     if (!adc_complete) return last_valid_temp;   // 返回上一次有效温度，避免频繁INVALID_TEMP
 
-    // 1. 中位数滤波
-    uint16_t sort_buffer[SAMPLES];
-    memcpy(sort_buffer, adc_buffer, sizeof(adc_buffer));
-    qsort(sort_buffer, SAMPLES, sizeof(uint16_t), compare_uint16);
-    uint16_t median_value = sort_buffer[SAMPLES / 2];
+    // 1. 中位数滤波（上电后抽取值不足 SAMPLES 个时使用已有的值）
+    __disable_irq();
+    uint16_t median_value = median_get(&adc_median);
     adc_complete          = false;
+    __enable_irq();
 
     // 检查NTC传感器损坏
     if (median_value < 267 || median_value > 3740)
@@ -149,15 +170,19 @@ void overheat_protection(float current_temp)
 void NTC_control(uint16_t dt_ms)
 {
     static uint32_t last_control = 0;
+    static bool heating          = false;   // 上一周期正在加热，用于识别加热开始
     uint32_t now                 = HAL_GetTick();
 
-    if (now - last_control < dt_ms) return;
+    // 由周期定时器按固定节拍调用，允许10%的调度抖动，避免偶发迟到导致跳过一次控温
+    if (now - last_control < dt_ms - dt_ms / 10) return;
     last_control = now;
 
     if (!register_get_value(REG_HEATING_STATUS) || overheat_protected)
     {
         __HAL_TIM_SetCompare(&htim1, TIM_CHANNEL_4, 0);
         PID_Reset(&heater_pid);   // 重置PID控制器
+        autotune_abort();
+        heating = false;
         return;
     }
 
@@ -169,12 +194,28 @@ void NTC_control(uint16_t dt_ms)
     {
         __HAL_TIM_SetCompare(&htim1, TIM_CHANNEL_4, 0);   // 无效温度时关闭加热
         PID_Reset(&heater_pid);                           // 重置PID控制器
+        autotune_abort();
+        heating = false;
         return;
     }
 
     overheat_protection(temp);
 
-    uint16_t pid_out = PID(&heater_pid, temp, target_temperature, dt_ms);
+    // 查表温度为 Q8.8，换回 Q8.8 没有精度损失
+    int16_t temp_q88   = (int16_t)(temp * 256.0f);
+    int16_t target_q88 = (int16_t)(target_temperature * 256.0f);
+    uint16_t pid_out;
+    if (autotune_active())
+    {
+        pid_out = autotune_step(&heater_pid, temp_q88, dt_ms);
+        heating = false;   // 整定结束后重新记录起始温度
+    } else
+    {
+        if (!heating) heater_model_begin(temp_q88);
+        heating                = true;
+        heater_pid.feedforward = heater_model_feedforward(target_q88);
+        pid_out                = PID(&heater_pid, temp_q88, target_q88, dt_ms);
+    }
     // DEBUG_PRINTF("PIDOutput: %d\n", pid_out);
     __HAL_TIM_SetCompare(&htim1, TIM_CHANNEL_4, pid_out);
 }
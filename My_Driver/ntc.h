@@ -9,6 +9,7 @@ void NTC_control(uint16_t dt);
 
 void    set_target_temperature(uint8_t temp);
 uint8_t get_target_temperature(void);
+int8_t  get_current_temperature(void);
 
 bool is_overheat(void);
 void clear_overheat_protection(void);
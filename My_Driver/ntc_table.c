@@ -0,0 +1,46 @@
+#include "ntc_table.h"
+
+#define NTC_KELVIN 273.15
+
+// exp(x) = exp(x/16)^16，exp(x/16) 取5阶泰勒展开；表中 |x| < 3，相对误差约 1e-6
+#define NTC_EXP_TAYLOR(y) (1.0 + (y) * (1.0 + (y) / 2.0 * (1.0 + (y) / 3.0 * (1.0 + (y) / 4.0 * (1.0 + (y) / 5.0)))))
+#define NTC_SQUARE(a) ((a) * (a))
+#define NTC_EXP(x) NTC_SQUARE(NTC_SQUARE(NTC_SQUARE(NTC_SQUARE(NTC_EXP_TAYLOR((x) / 16.0)))))
+
+// 温度t(℃)时 NTC 阻值与 R25 之比（B值公式）
+#define NTC_RATIO(t) NTC_EXP(NTC_B * (1.0 / ((t) + NTC_KELVIN) - 1.0 / (25.0 + NTC_KELVIN)))
+// 第i个表项：温度对应的 ADC 码值 ×16，四舍五入
+#define NTC_ENTRY(i) \
+    (uint16_t)(16.0 * 4095.0 / (1.0 + NTC_R_SERIES / (NTC_R25 * NTC_RATIO(NTC_T_MIN + (i) * NTC_T_STEP))) + 0.5)
+#define NTC_ROW(i)                                                                                         \
+    NTC_ENTRY(i), NTC_ENTRY(i + 1), NTC_ENTRY(i + 2), NTC_ENTRY(i + 3), NTC_ENTRY(i + 4), NTC_ENTRY(i + 5), \
+        NTC_ENTRY(i + 6), NTC_ENTRY(i + 7), NTC_ENTRY(i + 8), NTC_ENTRY(i + 9)
+
+// 温度升高时 NTC 阻值减小，表项单调递减
+static const uint16_t _AdcTable[NTC_TABLE_SIZE] = {
+    NTC_ROW(0),  NTC_ROW(10), NTC_ROW(20), NTC_ROW(30),  NTC_ROW(40),  NTC_ROW(50),
+    NTC_ROW(60), NTC_ROW(70), NTC_ROW(80), NTC_ROW(90), NTC_ROW(100), NTC_ROW(110), NTC_ENTRY(120),
+};
+
+int16_t ntc_adc_to_q88(uint16_t adc)
+{
+    uint32_t code = (uint32_t)adc << 4;
+    if (code > _AdcTable[0] || code < _AdcTable[NTC_TABLE_SIZE - 1]) return NTC_Q88_INVALID;
+
+    // 二分查找满足 _AdcTable[low] >= code > _AdcTable[low + 1] 的区间
+    uint8_t low  = 0;
+    uint8_t high = NTC_TABLE_SIZE - 1;
+    while (high - low > 1)
+    {
+        uint8_t mid = (low + high) / 2;
+        if (_AdcTable[mid] >= code)
+            low = mid;
+        else
+            high = mid;
+    }
+
+    uint32_t span = _AdcTable[low] - _AdcTable[high];
+    int32_t base  = (int32_t)(NTC_T_MIN + low * NTC_T_STEP) * 256;
+    int32_t frac  = (int32_t)(((_AdcTable[low] - code) * (NTC_T_STEP * 256u) + span / 2) / span);
+    return (int16_t)(base + frac);
+}
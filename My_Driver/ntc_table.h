@@ -0,0 +1,25 @@
+#ifndef __NTC_TABLE_H
+#define __NTC_TABLE_H
+
+#include <stdint.h>
+
+/*
+ * NTC 温度查表。
+ * - 表项为每个整数温度点对应的 ADC 码值（Q12.4），由下面的参数在编译期用常量表达式算出，修改参数后重新编译即更新，
+ *   运行时不再做浮点除法和 log()。
+ * - 查表用二分查找定位区间，再线性插值得到 Q8.8 温度。
+ * - 分压：NTC 接地，串联电阻 NTC_R_SERIES 接参考电压，ADC 为12位。
+ */
+#define NTC_B 3950.0           // B值
+#define NTC_R25 10000.0        // 25℃时阻值(Ω)
+#define NTC_R_SERIES 10000.0   // 分压电阻(Ω)
+#define NTC_T_MIN (-20)        // 表中最低温度(℃)，对应 ADC 约3740
+#define NTC_T_STEP 1           // 表中温度间隔(℃)
+#define NTC_TABLE_SIZE 121     // 表项数，覆盖 NTC_T_MIN ~ NTC_T_MIN + 120*NTC_T_STEP（100℃，ADC 约267）
+
+#define NTC_Q88_INVALID INT16_MIN   // 超出表范围
+
+// ADC 码值转 Q8.8 温度(℃)，超出表范围返回 NTC_Q88_INVALID
+int16_t ntc_adc_to_q88(uint16_t adc);
+
+#endif   // __NTC_TABLE_H
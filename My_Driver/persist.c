@@ -0,0 +1,51 @@
+#include "persist.h"
+#include "MultiTimer.h"
+#include "alarm.h"
+#include "autotune.h"
+#include "main.h"
+#include "register_interface.h"
+#include <stddef.h>
+
+// 各数据集的保存函数，按 PersistDataset 顺序
+static void (*const _SaveFunctions[PERSIST_COUNT])(void) = {
+    save_alarms,
+    save_config,
+    autotune_save,
+};
+
+static uint32_t _Dirty     = 0;   // bit n 置位：数据集 n 待保存
+static uint32_t _FirstTick = 0;   // 本轮第一次修改的时间
+static MultiTimer _PersistTimer;
+
+static void persist_task_callback(MultiTimer* timer, void* arg)
+{
+    persist_flush();
+}
+
+void persist_mark(PersistDataset dataset)
+{
+    uint32_t now = HAL_GetTick();
+    if (!_Dirty) _FirstTick = now;
+    _Dirty |= 1u << dataset;
+
+    // 每次修改重新计时，但不超过第一次修改后的最长推迟时间
+    uint32_t elapsed = now - _FirstTick;
+    uint32_t delay   = PERSIST_DELAY_MS;
+    if (elapsed + delay > PERSIST_MAX_DELAY_MS)
+    {
+        delay = (elapsed < PERSIST_MAX_DELAY_MS) ? PERSIST_MAX_DELAY_MS - elapsed : 0;
+    }
+    multiTimerStart(&_PersistTimer, delay, persist_task_callback, NULL);
+}
+
+void persist_flush(void)
+{
+    uint32_t dirty = _Dirty;
+    _Dirty         = 0;
+    multiTimerStop(&_PersistTimer);
+
+    for (uint8_t i = 0; i < PERSIST_COUNT; i++)
+    {
+        if (dirty & (1u << i)) _SaveFunctions[i]();
+    }
+}
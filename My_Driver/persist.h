@@ -0,0 +1,27 @@
+#ifndef __PERSIST_H
+#define __PERSIST_H
+
+#include <stdint.h>
+
+/*
+ * 延迟写入的参数保存服务。
+ * - 修改数据后调用 persist_mark() 标记数据集，由 MultiTimer 任务在停止修改 PERSIST_DELAY_MS 后统一写入，
+ *   APP连续重发整个闹钟表等突发修改只写一次Flash，且不阻塞协议处理和1ms刷新任务。
+ * - 持续修改时最多推迟 PERSIST_MAX_DELAY_MS。
+ * - 关机前调用 persist_flush() 同步写入所有待保存的数据集。
+ */
+#define PERSIST_DELAY_MS 500        // 最后一次修改后等待的时间
+#define PERSIST_MAX_DELAY_MS 3000   // 第一次修改后最长推迟时间
+
+typedef enum
+{
+    PERSIST_ALARMS = 0,   // 闹钟表
+    PERSIST_CONFIG,       // 寄存器配置（快捷键）
+    PERSIST_TUNING,       // 加热器整定结果
+    PERSIST_COUNT
+} PersistDataset;
+
+void persist_mark(PersistDataset dataset);
+void persist_flush(void);
+
+#endif   // __PERSIST_H
@@ -1,69 +1,70 @@
 #include "pid.h"
-#include <math.h>
 #include <stdint.h>
 #define CLAMP(x, low, high) (((x) > (high)) ? (high) : (((x) < (low)) ? (low) : (x)))
-// 初始化PID控制器
-void PID_Init(PID_Controller* pid, float Kp, float Ki, float Kd, float max_integral, float min_output, float max_output)
+// 初始化PID控制器，参数均为 Q16.16
+void PID_Init(PID_Controller* pid, int32_t Kp, int32_t Ki, int32_t Kd, int32_t max_integral, int32_t min_output,
+              int32_t max_output)
 {
     pid->Kp           = Kp;
     pid->Ki           = Ki;
     pid->Kd           = Kd;
-    pid->integral     = 0.0f;
-    pid->prev_error   = 0.0f;
-    pid->prev_input   = 0.0f;
+    pid->integral     = 0;
+    pid->prev_input   = 0;
     pid->max_integral = max_integral;
     pid->min_output   = min_output;
     pid->max_output   = max_output;
+    pid->feedforward  = 0;
     pid->first_run    = 1;
 }
 
 // 重置PID控制器
 void PID_Reset(PID_Controller* pid)
 {
-    pid->integral   = 0.0f;
-    pid->prev_error = 0.0f;
-    pid->prev_input = 0.0f;
+    pid->integral   = 0;
+    pid->prev_input = 0;
     pid->first_run  = 1;
 }
 
-// PID计算函数
-uint16_t PID(PID_Controller* pid, float input, float setpoint, uint16_t dt_ms)
+// PID计算函数：输入与设定值为 Q8.8，返回四舍五入后的输出
+// 比例项是 32×32→64 位乘法（一条 SMULL）；积分与微分项先移位、再与 dt 相乘，操作数是64位中间值，
+// 编译为 __aeabi_lmul 库调用（几条乘法指令）；除法只有两次32位除法，没有64位除法库调用
+uint16_t PID(PID_Controller* pid, int16_t input_q88, int16_t setpoint_q88, uint16_t dt_ms)
 {
-    float error  = setpoint - input;
-    float dt_sec = dt_ms / 1000.0f;
+    int32_t error  = (int32_t)setpoint_q88 - input_q88;   // Q8.8
+    int32_t dt_q16 = ((uint32_t)dt_ms << 16) / 1000;      // 采样周期（秒，Q16.16）
 
-    // 比例项
-    float P = pid->Kp * error;
+    // 比例项：Q16.16 × Q8.8 >> 8 = Q16.16
+    int64_t P = ((int64_t)pid->Kp * error) >> 8;
 
     // 积分项
-    if (fabsf(error) < 10.0f)   // 只在误差较小时启用积分
+    int32_t band = pid->feedforward ? PID_FF_INTEGRAL_BAND_Q88 : PID_INTEGRAL_BAND_Q88;
+    if (error > -band && error < band)   // 只在误差较小时启用积分
     {
-        pid->integral += pid->Ki * error * dt_sec;
+        int64_t step     = ((((int64_t)pid->Ki * error) >> 8) * dt_q16) >> 16;
+        int64_t integral = pid->integral + step;
+        int64_t limit    = pid->max_integral;
+        pid->integral    = (int32_t)CLAMP(integral, -limit, limit);   // 积分限幅
     } else
     {
-        pid->integral = 0.0f;   // 误差过大时清空积分
+        pid->integral = 0;   // 误差过大时清空积分
     }
-    // 积分限幅
-    if (pid->integral > pid->max_integral)
-        pid->integral = pid->max_integral;
-    else if (pid->integral < -pid->max_integral)
-        pid->integral = -pid->max_integral;
 
-    // 微分项
-    float D = 0.0f;
-    if (!pid->first_run)
+    // 微分项：对测量值求导，避免设定值跳变引起输出冲击
+    int64_t D = 0;
+    if (!pid->first_run && dt_ms > 0)
     {
-        float input_derivative = (input - pid->prev_input) / dt_sec;
-        D                      = -pid->Kd * input_derivative;
+        int32_t input_delta = (int32_t)input_q88 - pid->prev_input;   // Q8.8
+        int32_t rate_q16    = (int32_t)((1000u << 16) / dt_ms);       // 1/采样周期（每秒，Q16.16）
+        D                   = -(((((int64_t)pid->Kd * input_delta) >> 8) * rate_q16) >> 16);
     } else
     {
         pid->first_run = 0;
     }
-    pid->prev_input = input;
+    pid->prev_input = input_q88;
 
     // 计算输出
-    float output = P + pid->integral + D;
-    output       = CLAMP(output, pid->min_output, pid->max_output);
+    int64_t output = P + pid->integral + D + pid->feedforward;
+    output         = CLAMP(output, (int64_t)pid->min_output, (int64_t)pid->max_output);
 
-    return (uint16_t)(output + 0.5f);
+    return (uint16_t)((output + 0x8000) >> 16);
 }
@@ -4,24 +4,36 @@
 
 #include "main.h"
 
+/*
+ * 定点PID：温度为 Q8.8（℃），增益、积分与输出为 Q16.16，乘积用64位累加，运行时没有浮点运算。
+ * 增益等参数用 PID_Q16() 在编译期换算。
+ * 数值范围：误差与输入变化小于 2^16（Q8.8），dt_ms 为 1~65535，在此范围内64位中间值不溢出：
+ * - Kp、Ki 可取整个 int32：比例项不超过 2^39，积分步长的中间积不超过 2^61；
+ * - Kd 须小于 128.0（Q16.16 小于 2^23），微分项的中间积不超过 2^57，更大的 Kd 在 dt_ms=1 时可能溢出；
+ * - 积分在64位中相加后饱和到 ±max_integral 再存回，不会回绕；输出饱和到 [min_output, max_output]。
+ */
+#define PID_Q16(x) ((int32_t)((x) * 65536.0f + ((x) < 0 ? -0.5f : 0.5f)))   // 常数换算为 Q16.16
+#define PID_INTEGRAL_BAND_Q88 (10 * 256)                                     // 误差小于10℃时才积分
+#define PID_FF_INTEGRAL_BAND_Q88 (1 * 256)                                   // 有前馈时误差小于1℃才积分，只修正模型误差
+
 // PID控制器结构体
 typedef struct
 {
-    float   Kp;             // 比例增益
-    float   Ki;             // 积分增益
-    float   Kd;             // 微分增益
-    float   integral;       // 积分累积值
-    float   prev_error;     // 前一次误差
-    float   max_integral;   // 积分限幅值
-    float   min_output;     // 最小输出值
-    float   max_output;     // 最大输出值
-    float   prev_input;     // 前一次输入值（用于微分项）
+    int32_t Kp;             // 比例增益（Q16.16）
+    int32_t Ki;             // 积分增益（Q16.16，每秒）
+    int32_t Kd;             // 微分增益（Q16.16，秒）
+    int32_t integral;       // 积分累积值（Q16.16）
+    int32_t max_integral;   // 积分限幅值（Q16.16）
+    int32_t min_output;     // 最小输出值（Q16.16）
+    int32_t max_output;     // 最大输出值（Q16.16）
+    int32_t feedforward;    // 前馈输出（Q16.16），与PID输出相加后再限幅
+    int16_t prev_input;     // 前一次输入值（Q8.8，用于微分项）
     uint8_t first_run;      // 首次运行标志
 } PID_Controller;
 
-void     PID_Init(PID_Controller* pid, float Kp, float Ki, float Kd, float max_integral, float min_output,
-                  float max_output);
+void     PID_Init(PID_Controller* pid, int32_t Kp, int32_t Ki, int32_t Kd, int32_t max_integral, int32_t min_output,
+                  int32_t max_output);
 void     PID_Reset(PID_Controller* pid);
-uint16_t PID(PID_Controller* pid, float input_temp, float target_temp, uint16_t dt_ms);
+uint16_t PID(PID_Controller* pid, int16_t input_q88, int16_t setpoint_q88, uint16_t dt_ms);
 
 #endif
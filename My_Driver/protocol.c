@@ -1,5 +1,6 @@
 #include "protocol.h"
 #include "alarm.h"
+#include "at_cmd.h"
 #include "beep.h"
 #include "bt401.h"
 #include "crc16.h"
@@ -8,6 +9,8 @@
 #include "key.h"
 #include "led.h"
 #include "main.h"
+#include "ntc.h"
+#include "persist.h"
 #include "register_interface.h"
 #include <stdbool.h>
 #include <stdint.h>
@@ -19,72 +22,209 @@ extern Alarm_struct alarms[MAX_ALARMS];
 
 // 通信协议常量定义
 #define PROTOCOL_HEADER 0x01
+#define PROTOCOL_HEADER_SEQ 0x02   // 扩展帧头，其后紧跟1字节序号
 #define CMD_READ_REGISTER 0x03
 #define CMD_WRITE_REGISTER 0x10
-#define MAX_PACKET_SIZE 20
-#define BUFFER_SIZE 64
-#define TIMEOUT_MS 100
+#define CMD_SET_MTU 0x20      // MTU协商
+#define CMD_BULK_READ 0x41    // 批量读取
+#define CMD_BULK_WRITE 0x42   // 批量写入
+#define BUFFER_SIZE 128       // 未协商时的最大帧长，需容纳完整的批量传输帧
+#define TIMEOUT_MS 100   // 不完整帧的超时丢弃时间
+#define REPORT_COALESCE_MS 20   // 寄存器变化后等待合并的时间
 #define CHECKSUM_LENGTH 2
 
+// 错误应答：[头部(1)][命令|0x80(1)][错误码(1)][校验(2)]，错误码沿用 Modbus 异常码
+#define CMD_ERROR_FLAG 0x80
+#define ERR_ILLEGAL_ADDRESS 0x02   // 寄存器地址或范围非法
+#define ERR_ILLEGAL_VALUE 0x03     // 数量或写入值非法，或应答超出当前最大帧长
+#define ERR_DEVICE_BUSY 0x06       // 发送队列放不下应答
+
+// MTU协商：[头部(1)][0x20][MTU(2)][校验(2)]，应答 [头部(1)][0x20][生效的MTU(2)][最大帧长(2)][校验(2)]
+// 发送按MTU分包，接收帧长上限取 BUFFER_SIZE 与MTU中的较大者；应答按协商前的MTU发送，之后生效
+#define MTU_DEFAULT 20            // 未协商时每包字节数（BLE默认ATT负载）
+#define MTU_MAX 244               // BLE 4.2 数据长度扩展后的最大ATT负载
+#define FRAME_POOL_SIZE MTU_MAX   // 静态预留的接收帧缓冲区，按可协商的最大帧长分配
+
+// 批量传输：一帧内传完整个闹钟表、两个快捷键和状态快照，只有一个校验和一次应答，按MTU分包收发
+// 帧格式：[头部(1)][命令(1)][负载长度(2)][负载(n)][校验(2)]
+// 负载由若干段组成，每段为 [段ID(1)][段长度(1)][段数据(n)]
+// 批量读请求的负载为 1 字节段掩码，应答按段ID从小到大返回所请求的段
+// 批量写应答：[头部(1)][命令(1)][状态(1)][已写入的段掩码(1)][校验(2)]，任一段非法则整帧不写入
+#define BULK_HEADER_LEN 4
+#define BULK_SEC_ALARMS 0x01      // 闹钟表：MAX_ALARMS × [高位(2)][低位(2)]，格式同 REG_ALARM_SET_HIGH/LOW
+#define BULK_SEC_SHORTCUTS 0x02   // 快捷键：2 × [寄存器值(2)]，格式同 REG_SHORTCUT_KEY1/2
+#define BULK_SEC_STATE 0x04       // 状态快照（只读）：[参考寄存器(2n)][剩余秒数(4)][UTC时间戳(4)][温度(1)][状态位(1)]
+#define BULK_ALARMS_LEN (MAX_ALARMS * 4)
+#define BULK_SHORTCUTS_LEN 4
+#define BULK_STATE_LEN (2 * (REG_COUNT - REFRENCE_REG) + 4 + 4 + 1 + 1)
+#define BULK_STATUS_OK 0x00
+#define BULK_STATUS_INVALID 0x01   // 段ID或段长度非法
+
+// 流水线传输：请求使用扩展帧头 [0x02][序号(1)][命令(1)]...[校验(2)]，校验范围包含序号，命令之后与普通帧相同
+// 应答带回请求的序号，APP按序号匹配应答，无需等待上一条应答即可发送下一条
+// APP未确认的请求不超过 SEQ_WINDOW 条；最近 SEQ_WINDOW 条请求的序号被记录，重发的请求不会重复执行：
+// 缓存了应答的直接重发应答，应答过长未缓存的（只有读命令）重新执行
+// 序号0表示新会话开始，清空记录且不做去重；普通帧头的请求和主动上报均不带序号
+#define SEQ_WINDOW 8        // 最多未确认请求数，同时也是去重记录深度
+#define SEQ_RESP_CACHE 4    // 可缓存的应答数据长度，覆盖所有写应答
+#define SEQ_RESP_NONE 0     // 未发送应答
+#define SEQ_RESP_UNCACHED 0xFF
+
+typedef struct
+{
+    uint8_t seq;
+    uint8_t cmd;                    // 0 表示空记录
+    uint8_t resp_len;               // SEQ_RESP_NONE / SEQ_RESP_UNCACHED / 缓存的应答长度
+    uint8_t resp[SEQ_RESP_CACHE];   // 应答数据（不含帧头、命令和校验）
+} SeqRecord;
+
+static SeqRecord _SeqHistory[SEQ_WINDOW];
+static uint8_t _SeqNext       = 0;      // 下一条记录写入位置
+static SeqRecord* _SeqCurrent = NULL;   // 正在处理的带序号请求，应答需带回其序号
+
 // 静态缓冲区和状态变量
-static uint8_t _Buffer[BUFFER_SIZE];
+static uint8_t _Buffer[FRAME_POOL_SIZE];  // 当前帧已收到的字节
 static uint16_t _BufferLen = 0;
+static uint16_t _FrameLen  = 0;            // 当前帧总长度，0 表示尚未确定
+static uint16_t _HeaderLen = 1;            // 帧头长度：普通帧1，扩展帧2（含序号）
+static uint16_t _Crc       = CRC16_INIT;   // 当前帧的增量校验值
+static uint16_t _Mtu       = MTU_DEFAULT;   // 协商后的每包字节数
+static uint16_t _FrameMax  = BUFFER_SIZE;   // 协商后的最大帧长，不超过 FRAME_POOL_SIZE
+static uint8_t _TxData[FRAME_POOL_SIZE];    // 读应答与批量读应答的数据区，按最大帧长预留
+
+// 发送的一段数据，帧头、数据和校验分别作为一段，直接写入发送队列而不拼接
+typedef struct
+{
+    const uint8_t* data;
+    uint16_t len;
+} TxSegment;
 
-// 发送数据包到蓝牙设备，自动分包处理
-static void Bluetooth_Send_Packet(const uint8_t* data, uint16_t length)
+// 发送数据包到蓝牙设备，各段依次写入，按MTU分包（包边界可跨段）
+static void Bluetooth_Send_Packet(const TxSegment segments[], uint8_t count)
 {
-    uint16_t offset = 0;
-    while (length > 0)
+    uint16_t room = _Mtu;   // 当前包剩余字节数
+    for (uint8_t i = 0; i < count; i++)
     {
-        uint16_t packet_length = (length > MAX_PACKET_SIZE) ? MAX_PACKET_SIZE : length;
-        BT401_Write((uint8_t*)(data + offset), packet_length);
-        offset += packet_length;
-        length -= packet_length;
+        const uint8_t* data = segments[i].data;
+        uint16_t length     = segments[i].len;
+        while (length > 0)
+        {
+            uint16_t packet_length = (length > room) ? room : length;
+            BT401_Write((uint8_t*)data, packet_length);
+            data += packet_length;
+            length -= packet_length;
+            room -= packet_length;
+            if (room == 0) room = _Mtu;
+        }
     }
 }
 
-// 发送命令包，内部构建完整帧（头部+命令+数据+校验），避免修改外部缓冲区
-static void _send_cmd(uint8_t cmd, const uint8_t* data, uint16_t data_len)
+// 当前应答的数据部分最多可用的字节数（最大帧长减去帧头、命令和校验）
+static uint16_t _data_room(void)
 {
-    uint8_t frame[BUFFER_SIZE];                                     // 内部帧缓冲区，避免覆盖外部数据
-    if (data_len + 1 + 1 + CHECKSUM_LENGTH > BUFFER_SIZE) return;   // 避免帧溢出
+    return _FrameMax - (_SeqCurrent ? 3 : 2) - CHECKSUM_LENGTH;
+}
+
+// 发送命令包：帧头、数据和校验分段直接写入发送队列，不拷贝到中间帧缓冲区
+// 处理带序号的请求期间，应答使用扩展帧头带回序号，并缓存应答供重发请求使用；错误应答不缓存，重发的请求重新执行
+// 返回false表示整帧超长或发送队列放不下，未发送
+static bool _send_cmd(uint8_t cmd, const uint8_t* data, uint16_t data_len)
+{
+    uint8_t head[3];   // [头部][序号][命令]
+    uint8_t check[CHECKSUM_LENGTH];
+    uint16_t head_len = 0;
 
     // 构建帧头部
-    frame[0] = PROTOCOL_HEADER;
-    frame[1] = cmd;
+    head[head_len++] = _SeqCurrent ? PROTOCOL_HEADER_SEQ : PROTOCOL_HEADER;
+    if (_SeqCurrent)
+    {
+        head[head_len++] = _SeqCurrent->seq;
+        if (cmd & CMD_ERROR_FLAG)
+        {
+            if (_SeqCurrent->resp_len == SEQ_RESP_NONE) _SeqCurrent->resp_len = SEQ_RESP_UNCACHED;
+        } else if (data_len <= SEQ_RESP_CACHE)
+        {
+            memmove(_SeqCurrent->resp, data, data_len);   // 重发缓存的应答时源与目标相同
+            _SeqCurrent->resp_len = data_len;
+        } else
+        {
+            _SeqCurrent->resp_len = SEQ_RESP_UNCACHED;
+        }
+    }
+    head[head_len++] = cmd;
 
-    // 复制数据部分
-    memcpy(&frame[2], data, data_len);
+    // 整帧超长或发送队列放不下时整帧丢弃，避免发出半帧
+    uint16_t frame_len = head_len + data_len + CHECKSUM_LENGTH;
+    if (frame_len > _FrameMax || frame_len > BT401_TxFree()) return false;
 
-    // 计算并添加校验和
-    uint16_t checksum = _calc_check_value(frame, 2 + data_len);   // 校验范围：头部+命令+数据
-    _from_uint16(checksum, &frame[2 + data_len]);
+    // 计算校验和，校验范围：头部+命令+数据
+    uint16_t crc = crc16_update(crc16_init(), head, head_len);
+    crc          = crc16_update(crc, data, data_len);
+    _from_uint16(crc16_final(crc), check);
 
     // 发送完整帧
-    Bluetooth_Send_Packet(frame, 2 + data_len + CHECKSUM_LENGTH);
+    TxSegment segments[] = {{head, head_len}, {data, data_len}, {check, CHECKSUM_LENGTH}};
+    Bluetooth_Send_Packet(segments, ARRAY_SIZE(segments));
+    return true;
 }
 
-// 处理读寄存器命令
+static void _send_error(uint8_t cmd, uint8_t code)
+{
+    _send_cmd(cmd | CMD_ERROR_FLAG, &code, 1);
+}
+
+// 发送请求的应答，发不出时改为发送错误应答，不静默丢弃
+static void _reply(uint8_t cmd, const uint8_t* data, uint16_t data_len)
+{
+    if (!_send_cmd(cmd, data, data_len)) _send_error(cmd, ERR_DEVICE_BUSY);
+}
+
+// 处理MTU协商命令：应答后新的MTU与最大帧长才生效
+static void _do_set_mtu_cmd(uint16_t mtu)
+{
+    if (mtu < MTU_DEFAULT) mtu = MTU_DEFAULT;
+    if (mtu > MTU_MAX) mtu = MTU_MAX;
+    uint16_t frame_max = (mtu > BUFFER_SIZE) ? mtu : BUFFER_SIZE;
+
+    uint8_t resp_data[4];   // [生效的MTU(2)][最大帧长(2)]
+    _from_uint16(mtu, resp_data);
+    _from_uint16(frame_max, resp_data + 2);
+    _reply(CMD_SET_MTU, resp_data, sizeof(resp_data));
+
+    _Mtu      = mtu;
+    _FrameMax = frame_max;
+}
+
+// 处理读寄存器命令，应答超出当前最大帧长时只返回放得下的寄存器，首字节的数据字节数即实际数量
 static void _do_read_reg_cmd(uint16_t addr, uint16_t num)
 {
-    // 参数有效性检查
-    if (addr < REFRENCE_REG || addr >= REG_COUNT || num <= 0 || addr + num > REG_COUNT) return;
+    if (num == 0)
+    {
+        _send_error(CMD_READ_REGISTER, ERR_ILLEGAL_VALUE);
+        return;
+    }
+
+    // 参数有效性检查：普通读写寄存器区、任务统计区或启动时间区，不允许跨区读取
+    bool in_regs  = addr >= REFRENCE_REG && addr + num <= REG_COUNT;
+    bool in_stats = addr >= REG_TASK_STATS_BASE && addr + num <= REG_TASK_STATS_END;
+    bool in_boot  = addr >= REG_BOOT_TRACE_BASE && addr + num <= REG_BOOT_TRACE_END;
+    if (!in_regs && !in_stats && !in_boot)
+    {
+        _send_error(CMD_READ_REGISTER, ERR_ILLEGAL_ADDRESS);
+        return;
+    }
 
-    // 准备响应数据（格式：[数据字节数][寄存器值1][寄存器值2]...）
-    uint8_t resp_data[BUFFER_SIZE - 2];   // 预留头部和命令的位置
-    uint8_t resp_len = 1;                 // 首字节为数据字节数
-    resp_data[0]     = num * 2;           // 数据字节数 = 寄存器数量 * 2
+    // 响应数据格式：[数据字节数][寄存器值1][寄存器值2]...
+    uint16_t fit = (_data_room() - 1) / 2;
+    if (num > fit) num = fit;
+    _TxData[0] = num * 2;
 
-    // 填充寄存器值
     for (uint16_t i = 0; i < num; i++)
     {
-        if (resp_len + 2 > sizeof(resp_data)) return;   // 避免溢出
-        _from_uint16(register_get_value((RegisterID)(addr + i)), &resp_data[resp_len]);
-        resp_len += 2;
+        _from_uint16(register_get_value((RegisterID)(addr + i)), &_TxData[1 + 2 * i]);
     }
 
-    // 发送响应（命令=读命令，数据=响应数据）
-    _send_cmd(CMD_READ_REGISTER, resp_data, resp_len);
+    _reply(CMD_READ_REGISTER, _TxData, 1 + num * 2);
 }
 
 // 处理报警设置数据
@@ -99,6 +239,7 @@ static void _process_alarm(const uint8_t data[])
     if (temp_alarm.alarm_id < MAX_ALARMS)
     {
         alarms[temp_alarm.alarm_id] = temp_alarm;
+        persist_mark(PERSIST_ALARMS);
     }
 }
 
@@ -113,7 +254,21 @@ static void _process_utc_timestamp(const uint8_t data[])
 static void _do_write_reg_cmd(uint16_t addr, const uint8_t data[], uint8_t num)
 {
     // 参数有效性检查
-    if (num == 0 || addr + num > REG_COUNT) return;
+    if (num == 0 || addr + num > REG_COUNT)
+    {
+        _send_error(CMD_WRITE_REGISTER, ERR_ILLEGAL_ADDRESS);
+        return;
+    }
+
+    // 先检查所有取值，任一非法则整帧不写入
+    for (uint8_t i = 0; i < num; i++)
+    {
+        if (!register_host_write_valid((RegisterID)(addr + i), _to_uint16(data + 2 * i)))
+        {
+            _send_error(CMD_WRITE_REGISTER, ERR_ILLEGAL_VALUE);
+            return;
+        }
+    }
 
     // 准备写响应数据（格式：[地址高8位][地址低8位][数量高8位][数量低8位]）
     uint8_t resp_data[4];
@@ -137,16 +292,16 @@ static void _do_write_reg_cmd(uint16_t addr, const uint8_t data[], uint8_t num)
             {
                 case REG_ALARM_SET_HIGH:   // 闹钟
                     _process_alarm(data + 2 * i);
-                    _send_cmd(CMD_WRITE_REGISTER, resp_data, 4);   // 发送写响应
+                    _reply(CMD_WRITE_REGISTER, resp_data, 4);   // 发送写响应
                     return;
                 case REG_UTC_TIMESTAMP_HIGH:   // UTC时间戳
                     _process_utc_timestamp(data + 2 * i);
-                    _send_cmd(CMD_WRITE_REGISTER, resp_data, 4);   // 发送写响应
+                    _reply(CMD_WRITE_REGISTER, resp_data, 4);   // 发送写响应
                     return;
                 default:
                 {
                     _do_reg_changed(reg_id, value);
-                    _send_cmd(CMD_WRITE_REGISTER, resp_data, 4);   // 发送写响应
+                    _reply(CMD_WRITE_REGISTER, resp_data, 4);   // 发送写响应
                 }
 
                     return;
@@ -155,125 +310,383 @@ static void _do_write_reg_cmd(uint16_t addr, const uint8_t data[], uint8_t num)
     }
 
     // 所有寄存器写入完成后发送响应
-    _send_cmd(CMD_WRITE_REGISTER, resp_data, 4);
+    _reply(CMD_WRITE_REGISTER, resp_data, 4);
 }
 
-// 解析接收到的数据帧
-static bool _decode()
+// 批量读取：按段掩码组装应答，所请求的段超出当前最大帧长时回复错误
+static void _do_bulk_read(uint8_t sections)
 {
-    // 基本帧格式检查（至少包含：头部+命令+校验）
-    if (_BufferLen < 2 + CHECKSUM_LENGTH) return false;
+    uint8_t* data = _TxData;
+    uint16_t len  = 2;   // 前2字节为负载长度
+
+    uint16_t need = len;
+    if (sections & BULK_SEC_ALARMS) need += 2 + BULK_ALARMS_LEN;
+    if (sections & BULK_SEC_SHORTCUTS) need += 2 + BULK_SHORTCUTS_LEN;
+    if (sections & BULK_SEC_STATE) need += 2 + BULK_STATE_LEN;
+    if (need > _data_room())
+    {
+        _send_error(CMD_BULK_READ, ERR_ILLEGAL_VALUE);
+        return;
+    }
 
-    // 头部检查
-    if (_Buffer[0] != PROTOCOL_HEADER) return false;
+    if (sections & BULK_SEC_ALARMS)
+    {
+        data[len++] = BULK_SEC_ALARMS;
+        data[len++] = BULK_ALARMS_LEN;
+        for (uint8_t i = 0; i < MAX_ALARMS; i++)
+        {
+            uint16_t alarm_H, alarm_L;
+            compose_alarm_data(&alarms[i], &alarm_H, &alarm_L);
+            _from_uint16(alarm_H, &data[len]);
+            _from_uint16(alarm_L, &data[len + 2]);
+            len += 4;
+        }
+    }
 
-    uint8_t cmd  = _Buffer[1];
-    bool success = false;
+    if (sections & BULK_SEC_SHORTCUTS)
+    {
+        data[len++] = BULK_SEC_SHORTCUTS;
+        data[len++] = BULK_SHORTCUTS_LEN;
+        _from_uint16(register_get_value(REG_SHORTCUT_KEY1), &data[len]);
+        _from_uint16(register_get_value(REG_SHORTCUT_KEY2), &data[len + 2]);
+        len += 4;
+    }
 
-    switch (cmd)
+    if (sections & BULK_SEC_STATE)
     {
-        case CMD_READ_REGISTER:
+        data[len++] = BULK_SEC_STATE;
+        data[len++] = BULK_STATE_LEN;
+        for (uint16_t reg = REFRENCE_REG; reg < REG_COUNT; reg++)
         {
-            // 读命令格式：[头部(1)][命令(1)][地址(2)][数量(2)][校验(2)] → 总长度8
-            if (_BufferLen < 6 + CHECKSUM_LENGTH) return false;
-
-            // 校验和检查
-            uint16_t recv_check = _to_uint16(&_Buffer[6]);
-            uint16_t calc_check = _calc_check_value(_Buffer, 6);
-            if (recv_check != calc_check) return false;
-
-            // 解析地址和数量并处理
-            uint16_t addr = _to_uint16(&_Buffer[2]);
-            uint16_t num  = _to_uint16(&_Buffer[4]);
-            _do_read_reg_cmd(addr, num);
-            success = true;
-            break;
-        }   // 代码块结束
+            _from_uint16(register_get_value((RegisterID)reg), &data[len]);
+            len += 2;
+        }
+        uint32_t remaining = get_remaining_seconds();
+        uint32_t utc       = read_utc() - 28800;   // 本地时间转回UTC，与写入时的时区转换对应
+        _from_uint16(remaining >> 16, &data[len]);
+        _from_uint16(remaining & 0xFFFF, &data[len + 2]);
+        _from_uint16(utc >> 16, &data[len + 4]);
+        _from_uint16(utc & 0xFFFF, &data[len + 6]);
+        data[len + 8] = (uint8_t)get_current_temperature();
+        data[len + 9] = (is_heating_active() ? 0x01 : 0) | (is_music_active() ? 0x02 : 0) | (is_overheat() ? 0x04 : 0);
+        len += 10;
+    }
 
-        case CMD_WRITE_REGISTER:
+    _from_uint16(len - 2, data);
+    _reply(CMD_BULK_READ, data, len);
+}
+
+// 批量写入的段是否合法（状态快照只读）
+static bool _bulk_section_valid(uint8_t id, uint8_t len)
+{
+    return (id == BULK_SEC_ALARMS && len == BULK_ALARMS_LEN) || (id == BULK_SEC_SHORTCUTS && len == BULK_SHORTCUTS_LEN);
+}
+
+// 整表写入闹钟，由 persist 服务合并后延迟保存
+static void _apply_bulk_alarms(const uint8_t data[])
+{
+    for (uint8_t i = 0; i < MAX_ALARMS; i++)
+    {
+        Alarm_struct temp_alarm;
+        parse_alarm_data(_to_uint16(data + 4 * i), _to_uint16(data + 4 * i + 2), &temp_alarm);
+        temp_alarm.alarm_id        = i;                           // 按表中位置存放
+        temp_alarm.triggered_today = alarms[i].triggered_today;   // 保留今日触发标志，避免同一分钟内重复响铃
+        alarms[i]                  = temp_alarm;
+    }
+    persist_mark(PERSIST_ALARMS);
+}
+
+// 批量写入：先校验所有段，全部合法后再逐段写入，最后只发送一次应答
+static void _do_bulk_write(const uint8_t payload[], uint16_t len)
+{
+    uint8_t resp_data[2] = {BULK_STATUS_OK, 0};   // [状态][已写入的段掩码]
+
+    for (uint16_t pos = 0; pos < len; pos += 2 + payload[pos + 1])
+    {
+        if (len - pos < 2 || len - pos - 2 < payload[pos + 1] || !_bulk_section_valid(payload[pos], payload[pos + 1]))
+        {
+            resp_data[0] = BULK_STATUS_INVALID;
+            _reply(CMD_BULK_WRITE, resp_data, sizeof(resp_data));
+            return;
+        }
+    }
+
+    for (uint16_t pos = 0; pos < len; pos += 2 + payload[pos + 1])
+    {
+        const uint8_t* data = &payload[pos + 2];
+        switch (payload[pos])
         {
+            case BULK_SEC_ALARMS: _apply_bulk_alarms(data); break;
+            case BULK_SEC_SHORTCUTS:
+                register_set_value(REG_SHORTCUT_KEY1, _to_uint16(data));
+                register_set_value(REG_SHORTCUT_KEY2, _to_uint16(data + 2));
+                break;
+            default: break;
+        }
+        resp_data[1] |= payload[pos];
+    }
+
+    _reply(CMD_BULK_WRITE, resp_data, sizeof(resp_data));
+}
+
+typedef enum
+{
+    FRAME_MORE = 0,   // 帧未完整，继续接收
+    FRAME_DONE,       // 收到完整且校验正确的帧
+    FRAME_ERROR       // 命令或长度非法、校验错误
+} FrameResult;
+
+// 执行一条命令，frame[0] 对应普通帧的头部位置
+static void _execute(const uint8_t frame[])
+{
+    uint16_t addr = _to_uint16(&frame[2]);
+
+    switch (frame[1])
+    {
+        case CMD_READ_REGISTER:
+            // 读命令格式：[头部(1)][命令(1)][地址(2)][数量(2)][校验(2)]
+            _do_read_reg_cmd(addr, _to_uint16(&frame[4]));
+            break;
+        case CMD_WRITE_REGISTER:
             // 写命令格式：[头部(1)][命令(1)][地址(2)][数量(2)][数据长度(1)][数据(n)][校验(2)]
-            if (_BufferLen < 7 + CHECKSUM_LENGTH)   // 最小长度：7（头部到数据长度）+2（校验）
-                return false;
-
-            uint8_t data_len   = _Buffer[6];
-            uint16_t total_len = 7 + data_len + CHECKSUM_LENGTH;   // 总帧长
-            if (_BufferLen < total_len)                            // 数据未接收完整
-                return false;
-
-            // 校验和检查
-            uint16_t recv_check = _to_uint16(&_Buffer[7 + data_len]);
-            uint16_t calc_check = _calc_check_value(_Buffer, 7 + data_len);
-            if (recv_check != calc_check) return false;
-
-            // 解析地址和数量并处理（数量=数据长度/2，每个寄存器2字节）
-            uint16_t addr    = _to_uint16(&_Buffer[2]);
-            uint16_t num_reg = data_len / 2;
-            if (num_reg == 0 || data_len % 2 != 0)   // 数据长度必须为偶数
-                return false;
-
-            _do_write_reg_cmd(addr, &_Buffer[7], num_reg);
-            success = true;
+            _do_write_reg_cmd(addr, &frame[7], frame[6] / 2);   // 数量=数据长度/2，每个寄存器2字节
+            break;
+        case CMD_SET_MTU:
+            // MTU协商格式：[头部(1)][命令(1)][MTU(2)][校验(2)]
+            _do_set_mtu_cmd(addr);
             break;
-        }   // 代码块结束
+        case CMD_BULK_READ:
+            // 批量读格式：[头部(1)][命令(1)][负载长度(2)=1][段掩码(1)][校验(2)]
+            _do_bulk_read(frame[BULK_HEADER_LEN]);
+            break;
+        case CMD_BULK_WRITE:
+            // 批量写格式：[头部(1)][命令(1)][负载长度(2)][段(n)...][校验(2)]
+            _do_bulk_write(&frame[BULK_HEADER_LEN], _to_uint16(&frame[2]));
+            break;
+        default: break;
+    }
+}
+
+// 执行带序号的请求：最近处理过的序号视为APP重发，不重复执行
+static void _execute_seq(uint8_t seq, const uint8_t frame[])
+{
+    if (seq == 0) memset(_SeqHistory, 0, sizeof(_SeqHistory));   // 新会话
 
-        default: return false;   // 未知命令
+    for (uint8_t i = 0; seq != 0 && i < SEQ_WINDOW; i++)
+    {
+        SeqRecord* record = &_SeqHistory[i];
+        if (record->cmd != frame[1] || record->seq != seq) continue;
+
+        _SeqCurrent = record;
+        if (record->resp_len == SEQ_RESP_UNCACHED)
+            _execute(frame);   // 只有读命令的应答会超出缓存，重新读取没有副作用
+        else if (record->resp_len != SEQ_RESP_NONE)
+            _reply(record->cmd, record->resp, record->resp_len);
+        _SeqCurrent = NULL;
+        return;
     }
 
-    return success;
+    _SeqCurrent           = &_SeqHistory[_SeqNext];
+    _SeqCurrent->seq      = seq;
+    _SeqCurrent->cmd      = frame[1];
+    _SeqCurrent->resp_len = SEQ_RESP_NONE;
+    _SeqNext              = (_SeqNext + 1) % SEQ_WINDOW;
+    _execute(frame);
+    _SeqCurrent = NULL;
 }
 
-// 协议轮询函数，处理蓝牙数据接收和解析
-void protocol_poll(void)
+// 处理一个完整的数据帧（已通过校验）
+static void _dispatch(void)
 {
-    static uint32_t _tick = 0;
+    const uint8_t* frame = &_Buffer[_HeaderLen - 1];   // 扩展帧跳过序号，之后按普通帧解析
+
+    if (_HeaderLen == 2)
+        _execute_seq(_Buffer[1], frame);
+    else
+        _execute(frame);
+    beep_start(5, 2);   // 解析成功提示
+}
+
+static bool _is_header(uint8_t byte)
+{
+    return byte == PROTOCOL_HEADER || byte == PROTOCOL_HEADER_SEQ;
+}
 
-    // 读取蓝牙数据（避免缓冲区溢出）
-    uint16_t available = sizeof(_Buffer) - _BufferLen;
-    if (available > 0)
+static void _reset_parser(void)
+{
+    _BufferLen = 0;
+    _FrameLen  = 0;
+    _Crc       = crc16_init();
+}
+
+// 处理刚存入 _Buffer[_BufferLen - 1] 的字节，随收随算校验
+static FrameResult _advance(void)
+{
+    uint16_t pos = _BufferLen - 1;
+    uint8_t byte = _Buffer[pos];
+
+    if (pos == 0) _HeaderLen = (byte == PROTOCOL_HEADER_SEQ) ? 2 : 1;
+
+    // 命令之后的字段与普通帧相同，扩展帧整体后移 base 个字节
+    uint16_t base        = _HeaderLen - 1;
+    const uint8_t* frame = &_Buffer[base];
+
+    if (pos == base + 1)
+    {
+        if (byte == CMD_READ_REGISTER)
+            _FrameLen = base + 6 + CHECKSUM_LENGTH;
+        else if (byte == CMD_SET_MTU)
+            _FrameLen = base + 4 + CHECKSUM_LENGTH;
+        else if (byte != CMD_WRITE_REGISTER && byte != CMD_BULK_READ && byte != CMD_BULK_WRITE)
+            return FRAME_ERROR;   // 未知命令
+    } else if (pos == base + 3 && (frame[1] == CMD_BULK_READ || frame[1] == CMD_BULK_WRITE))
+    {
+        // 批量读负载固定为1字节段掩码；批量写负载非空，且整帧不超过缓冲区
+        uint16_t payload_len = _to_uint16(&frame[2]);
+        if (payload_len == 0 || base + BULK_HEADER_LEN + payload_len + CHECKSUM_LENGTH > _FrameMax)
+            return FRAME_ERROR;
+        if (frame[1] == CMD_BULK_READ && payload_len != 1) return FRAME_ERROR;
+        _FrameLen = base + BULK_HEADER_LEN + payload_len + CHECKSUM_LENGTH;
+    } else if (pos == base + 6 && frame[1] == CMD_WRITE_REGISTER)
+    {
+        // 数据长度必须为非零偶数，且整帧不超过缓冲区
+        if (byte == 0 || byte % 2 != 0 || base + 7 + byte + CHECKSUM_LENGTH > _FrameMax) return FRAME_ERROR;
+        _FrameLen = base + 7 + byte + CHECKSUM_LENGTH;
+    }
+
+    if (_FrameLen == 0 || pos < _FrameLen - CHECKSUM_LENGTH)
+    {
+        _Crc = crc16_update(_Crc, &byte, 1);
+        return FRAME_MORE;
+    }
+    if (_BufferLen < _FrameLen) return FRAME_MORE;
+
+    return (_to_uint16(&_Buffer[_FrameLen - CHECKSUM_LENGTH]) == crc16_final(_Crc)) ? FRAME_DONE : FRAME_ERROR;
+}
+
+// 当前帧解析失败：丢弃其头部，从缓冲区中已收到的后续字节里重新查找帧（避免丢失紧随其后的完整帧）
+static void _resync(void)
+{
+    uint16_t len   = _BufferLen;
+    uint16_t start = 1;
+
+    while (start < len)
     {
-        uint16_t read_len = BT401_Read(&_Buffer[_BufferLen], available);
-        if (read_len > 0)
+        while (start < len && !_is_header(_Buffer[start])) start++;
+        memmove(_Buffer, &_Buffer[start], len - start);
+        len -= start;
+        _reset_parser();
+
+        FrameResult result = FRAME_MORE;
+        while (_BufferLen < len && result == FRAME_MORE)
         {
-            _BufferLen += read_len;
-            _tick = HAL_GetTick();   // 更新超时计时
+            _BufferLen++;
+            result = _advance();
         }
+        if (result == FRAME_MORE) return;   // 剩余字节是一帧的开头，继续等待
+
+        if (result == FRAME_DONE) _dispatch();
+        start = (result == FRAME_DONE) ? _FrameLen : 1;
     }
+    _reset_parser();
+}
 
-    // 处理超时或缓冲区满的情况
-    bool timeout = (_BufferLen > 0) && (HAL_GetTick() - _tick >= TIMEOUT_MS);
-    if (_BufferLen >= sizeof(_Buffer) || timeout)
+// 逐字节输入接收到的数据，帧的最后一个字节到达即处理
+void protocol_input(const uint8_t* data, uint16_t len)
+{
+    for (uint16_t i = 0; i < len; i++)
     {
-        bool success = _decode();
+        if (_BufferLen == 0 && !_is_header(data[i])) continue;   // 等待帧头
 
-        if (success)
+        _Buffer[_BufferLen++] = data[i];
+        FrameResult result    = _advance();
+        if (result == FRAME_DONE)
         {
-            beep_start(5, 2);   // 解析成功提示
-            _BufferLen = 0;     // 成功解析后清空缓冲区
-        } else
+            _dispatch();
+            _reset_parser();
+        } else if (result == FRAME_ERROR)
         {
-            // 解析失败：查找下一个可能的头部，保留后续数据（避免丢失完整帧）
-            uint16_t next_header = 0;
-            for (next_header = 1; next_header < _BufferLen; next_header++)
-            {
-                if (_Buffer[next_header] == PROTOCOL_HEADER)
-                {
-                    // 移动数据到缓冲区头部
-                    memmove(_Buffer, &_Buffer[next_header], _BufferLen - next_header);
-                    _BufferLen -= next_header;
-                    _tick = HAL_GetTick();   // 重置超时计时
-                    return;
-                }
-            }
-            // 未找到头部，清空缓冲区
-            memset(_Buffer, 0, sizeof(_Buffer));
-            BT401_Write(_Buffer, _BufferLen);   // 回显错误数据
-            _BufferLen = 0;
+            _resync();
         }
     }
 }
 
-// 上传参考寄存器值（主动上报）
+// 蓝牙连接状态变化（新连接或断开）时调用：协商结果只对一次连接有效，恢复默认MTU与最大帧长，
+// 并清空序号记录和未收齐的帧
+void protocol_reset_session(void)
+{
+    _Mtu      = MTU_DEFAULT;
+    _FrameMax = BUFFER_SIZE;
+    memset(_SeqHistory, 0, sizeof(_SeqHistory));
+    _reset_parser();
+}
+
+// 协议轮询函数，处理蓝牙数据接收和解析
+void protocol_poll(void)
+{
+    static uint32_t _tick = 0;
+    uint8_t rx[32];
+
+    // AT指令等待应答期间接收数据归AT引擎
+    if (at_owns_rx()) return;
+
+    uint16_t read_len;
+    while ((read_len = BT401_Read(rx, sizeof(rx))) > 0)
+    {
+        protocol_input(rx, read_len);
+        _tick = HAL_GetTick();   // 更新超时计时
+    }
+
+    // 半帧超时：丢弃不完整的帧，从其后的字节重新查找帧头
+    if (_BufferLen > 0 && HAL_GetTick() - _tick >= TIMEOUT_MS)
+    {
+        _resync();
+        _tick = HAL_GetTick();
+    }
+}
+
+// 上报变化的寄存器：按写寄存器帧格式发送覆盖所有变化寄存器的最小连续区间，返回是否已发送
+static bool _report_registers(uint32_t mask)
+{
+    uint8_t first = 0;
+    uint8_t last  = 31;
+    while (!(mask & (1u << first))) first++;
+    while (!(mask & (1u << last))) last--;
+
+    uint16_t addr = REFRENCE_REG + first;
+    uint8_t num   = last - first + 1;
+    uint8_t data[5 + 2 * (REG_COUNT - REFRENCE_REG)];   // [地址(2)][数量(2)][数据长度(1)][数据(n)]
+    _from_uint16(addr, data);
+    _from_uint16(num, data + 2);
+    data[4] = num * 2;
+    for (uint8_t i = 0; i < num; i++)
+    {
+        _from_uint16(register_get_value((RegisterID)(addr + i)), &data[5 + 2 * i]);
+    }
+    return _send_cmd(CMD_WRITE_REGISTER, data, 5 + num * 2);
+}
+
+// 变化通知：收集变化位图，合并 REPORT_COALESCE_MS 内的连续变化后立即上报
+void report_poll(void)
+{
+    static uint32_t _pending = 0;
+    static uint32_t _tick    = 0;
+
+    uint32_t dirty = register_take_dirty();
+    if (dirty)
+    {
+        if (!_pending) _tick = HAL_GetTick();   // 第一个变化开始计时
+        _pending |= dirty;
+    }
+
+    // 发送队列放不下时保留变化位图，下次轮询重试
+    if (_pending && HAL_GetTick() - _tick >= REPORT_COALESCE_MS && _report_registers(_pending))
+    {
+        _pending = 0;
+    }
+}
+
+// 上传参考寄存器值（主动上报，低频保活）
 void upload_reg_value(void)
 {
     uint8_t resp_data[1 + 12];   // [数据字节数(1)][6个寄存器×2字节(12)]
@@ -11,6 +11,9 @@
 #include <stdint.h>
 
 void protocol_poll(void);
+void protocol_input(const uint8_t* data, uint16_t len);
+void protocol_reset_session(void);
 void _save_config(void);
 void upload_reg_value(void);
+void report_poll(void);
 #endif /* PROTOCOL_INCLUDED_1143021412418368 */
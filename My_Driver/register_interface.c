@@ -1,67 +1,106 @@
 // register_interface.c
 #include "register_interface.h"
 #include "alarm.h"
+#include "autotune.h"
 #include "beep.h"
+#include "boot.h"
 #include "bt401.h"
 #include "crc16.h"
 #include "flash.h"
 #include "hardware_register.h"
+#include "kv_store.h"
 #include "led.h"
+#include "persist.h"
 #include "protocol.h"
 #include "shortcut.h"
 #include <stddef.h>
 #include <string.h>
 
 static uint16_t _RegValue[REG_COUNT - REFRENCE_REG + 1];
-static uint16_t _RegValueBackup[REG_COUNT - REFRENCE_REG + 1];
-
-
-// static inline void _load_config(void)
-// {
-//     static const uint16_t _defaultValue[] = {
-//         0,   // RF工作状态
-//         0,   // RF档位
-//         0,   // 工作定时(分钟)
-//         0,   // 快捷键1
-//         0,   // 快捷键2
-//     };
-
-//     // 读取配置
-//     flash_read(FLASH_START_ADDR, (uint8_t*)_RegValue, sizeof(_RegValue));
-//     if (_calc_check_value((uint8_t*)_RegValue, sizeof(_RegValue) - sizeof(uint16_t)) !=
-//         _RegValue[ARRAY_SIZE(_RegValue) - 1])
-//     {
-//         memcpy(_RegValue, _defaultValue, sizeof(_defaultValue));
-//     }
-
-//     // 初始化寄存器值
-//     _RegValue[REG_HEATING_TIMER - REFRENCE_REG]  = 0;
-//     _RegValue[REG_HEATING_LEVEL - REFRENCE_REG]  = 0;
-//     _RegValue[REG_HEATING_STATUS - REFRENCE_REG] = 0;
-
-//     // 备份寄存器值
-//     memcpy(_RegValueBackup, _RegValue, sizeof(_RegValue));
-// }
+static volatile uint32_t _DirtyMask = 0;   // bit n 置位：寄存器 REFRENCE_REG+n 自上次上报后有变化
 
+#define CONFIG_VERSION 1   // 配置结构版本，修改 ConfigBlob 时递增，并在 _migrate_config 中补充旧版本的转换
+
+/*
+ * 保存在参数存储区 KV_KEY_CONFIG 中的配置，开机只读取这一条记录（记录自带CRC）即可恢复。
+ * 热敷状态、档位、定时出于安全考虑不保存，开机总是关闭。
+ */
+typedef struct
+{
+    uint8_t version;        // CONFIG_VERSION
+    uint8_t reserved;
+    uint16_t shortcut[2];   // 快捷键1、2寄存器值
+} ConfigBlob;
+
+static ConfigBlob _SavedConfig;   // 参数存储区中当前的配置，与之相同时不写入
+
+static void _compose_config(ConfigBlob* config)
+{
+    config->version     = CONFIG_VERSION;
+    config->reserved    = 0;
+    config->shortcut[0] = _RegValue[REG_SHORTCUT_KEY1 - REFRENCE_REG];
+    config->shortcut[1] = _RegValue[REG_SHORTCUT_KEY2 - REFRENCE_REG];
+}
+
+// 把已保存的配置转换为当前版本，没有可用的配置时为默认值
+static void _migrate_config(const uint8_t* raw, uint8_t len, ConfigBlob* config)
+{
+    config->version     = CONFIG_VERSION;
+    config->reserved    = 0;
+    config->shortcut[0] = shortcut_default_value(0);
+    config->shortcut[1] = shortcut_default_value(1);
+    if (len == 0) return;   // 没有配置记录或CRC校验失败
+
+    switch (raw[0])
+    {
+        case 1:
+            if (len == sizeof(ConfigBlob)) memcpy(config, raw, sizeof(ConfigBlob));
+            break;
+        default: break;   // 未知版本（如固件降级），使用默认值
+    }
+}
+
+static void _load_config(void)
+{
+    uint8_t raw[KV_MAX_VALUE_LEN];
+    uint8_t len = kv_read(KV_KEY_CONFIG, raw, sizeof(raw));
+    ConfigBlob config;
+    _migrate_config(raw, len, &config);
+
+    // 直接写入寄存器，不触发变化处理
+    _RegValue[REG_SHORTCUT_KEY1 - REFRENCE_REG] = config.shortcut[0];
+    _RegValue[REG_SHORTCUT_KEY2 - REFRENCE_REG] = config.shortcut[1];
+
+    // 读到的就是当前版本时无需写回；迁移或使用默认值时写回一次，下次开机只需读取
+    if (len == sizeof(ConfigBlob) && memcmp(raw, &config, sizeof(ConfigBlob)) == 0)
+    {
+        _SavedConfig = config;
+    } else
+    {
+        memset(&_SavedConfig, 0, sizeof(_SavedConfig));   // 版本0不会与当前配置相同，保证写回
+        persist_mark(PERSIST_CONFIG);
+    }
+}
+
+// 配置有变化时写入参数存储区，由 persist 服务调用
 void save_config(void)
 {
-    if (memcmp(_RegValueBackup, _RegValue, sizeof(_RegValue)) != 0)
+    ConfigBlob config;
+    _compose_config(&config);
+    if (memcmp(&config, &_SavedConfig, sizeof(config)) == 0) return;
+
+    if (kv_write(KV_KEY_CONFIG, &config, sizeof(config)) == FLASH_OK)
+    {
+        _SavedConfig = config;
+    } else
     {
-        _RegValue[ARRAY_SIZE(_RegValue) - 1] =
-            _calc_check_value((uint8_t*)_RegValue, sizeof(_RegValue) - sizeof(uint16_t));
-        if (flash_write(FLASH_START_ADDR, (uint8_t*)_RegValue, sizeof(_RegValue)) == FLASH_OK)
-        {
-            memcpy(_RegValueBackup, _RegValue, sizeof(_RegValue));
-        } else
-        {
-            DEBUG_PRINTF("Flash write error\r\n");
-        }
+        DEBUG_PRINTF("Flash write error\r\n");
     }
 }
 
 void register_interface_init(void)
 {
-    // _load_config();
+    _load_config();
     update_hardware_registers(&_RegValue[1], 3);
 }
 
@@ -79,12 +118,37 @@ bool register_set_value(RegisterID id, uint16_t value)
     }
 
     *reg_ptr = value;
+    _DirtyMask |= 1u << (id - REFRENCE_REG);
     _do_reg_changed(id, value);
     return true;
 }
 
+bool register_host_write_valid(RegisterID id, uint16_t value)
+{
+    switch (id)
+    {
+        case REG_AUTOTUNE: return value == AUTOTUNE_IDLE || value == AUTOTUNE_RUNNING;   // 完成/失败只能由整定过程写入
+        default: return true;
+    }
+}
+
+uint32_t register_take_dirty(void)
+{
+    uint32_t mask = _DirtyMask;
+    _DirtyMask    = 0;
+    return mask;
+}
+
 uint16_t register_get_value(RegisterID id)
 {
+    if (id >= REG_TASK_STATS_BASE && id < REG_TASK_STATS_END)
+    {
+        return multiTimerStatsRegister(id - REG_TASK_STATS_BASE);   // 任务统计只读寄存器
+    }
+    if (id >= REG_BOOT_TRACE_BASE && id < REG_BOOT_TRACE_END)
+    {
+        return boot_trace_get_register(id - REG_BOOT_TRACE_BASE);   // 启动时间只读寄存器
+    }
     return (id >= REFRENCE_REG && id < REG_COUNT) ? _RegValue[id - REFRENCE_REG] : 0;
 }
 
@@ -98,6 +162,12 @@ void _do_reg_changed(uint16_t reg, uint16_t value)
         case REG_HEATING_STATUS: rf_switch(value); break;
         case REG_HEATING_LEVEL: rf_level(value); break;
         case REG_HEATING_TIMER: rf_time(value); break;
+        case REG_SHORTCUT_KEY1:
+        case REG_SHORTCUT_KEY2: persist_mark(PERSIST_CONFIG); break;
+        case REG_AUTOTUNE:
+            if (value == AUTOTUNE_RUNNING) autotune_start();
+            else if (value == AUTOTUNE_IDLE) autotune_abort();
+            break;   // 完成/失败状态由整定过程写入，APP 写入时已被 register_host_write_valid 拒绝
         default: break;
     }
 }
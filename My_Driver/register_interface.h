@@ -1,6 +1,7 @@
 #ifndef REGISTER_INTERFACE_H
 #    define REGISTER_INTERFACE_H
 
+#    include "MultiTimer.h"
 #    include <stdbool.h>
 #    include <stdint.h>
 typedef enum
@@ -17,10 +18,21 @@ typedef enum
     REG_HEATING_TIMER,        // 热敷工作定时
     REG_SHORTCUT_KEY1,        // 快捷键1
     REG_SHORTCUT_KEY2,        // 快捷键2
+    REG_AUTOTUNE,             // 加热器自整定：写1开始、写0取消（其他值被拒绝），读为 AutotuneState
     REG_COUNT,
+
+    REG_TASK_STATS_BASE = 0x0100,   // 任务运行统计（只读），每个任务占 REG_TASK_STATS_STRIDE 个寄存器
+    REG_BOOT_TRACE_BASE = 0x0180,   // 启动各阶段完成时间（只读，ms），每个阶段一个寄存器
 } RegisterID;
 
 #    define REFRENCE_REG REG_HEATING_STATUS
+
+// 任务统计寄存器布局见 MultiTimer.h 中的 MULTITIMER_STATS_REGISTERS
+#    define REG_TASK_STATS_STRIDE MULTITIMER_STATS_REGISTERS
+#    define REG_TASK_STATS_TASKS 10
+#    define REG_TASK_STATS_END (REG_TASK_STATS_BASE + REG_TASK_STATS_STRIDE * REG_TASK_STATS_TASKS)
+#    define REG_BOOT_TRACE_STAGES 8
+#    define REG_BOOT_TRACE_END (REG_BOOT_TRACE_BASE + REG_BOOT_TRACE_STAGES)
 #    define ARRAY_SIZE(arr) (sizeof(arr) / sizeof((arr)[0]))
 
 uint16_t _calc_check_value(const uint8_t data[], uint32_t dataLen);
@@ -31,9 +43,13 @@ void register_interface_init(void);
 
 // 设置寄存器值
 bool register_set_value(RegisterID id, uint16_t value);
+// APP 写入前检查取值：只允许写入命令值，设备上报的状态值只读
+bool register_host_write_valid(RegisterID id, uint16_t value);
 void _do_reg_changed(uint16_t reg, uint16_t value);
 // 获取寄存器值
 uint16_t register_get_value(RegisterID id);
+// 取出并清除变化位图，bit n 对应寄存器 REFRENCE_REG+n
+uint32_t register_take_dirty(void);
 
 void save_config(void);
 
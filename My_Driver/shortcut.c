@@ -31,20 +31,16 @@ int8_t reset_act_shortcut_id(int8_t id)
     active_shortcut_id = 0;   // 重置激活状态
     return 0;                 // 成功
 }
-void shortcut_init(void)
+// 快捷键默认值，参数存储区没有保存的配置时使用
+uint16_t shortcut_default_value(uint8_t index)
 {
-    shortcut[0].heat_level    = 0;    // 35℃，默认档位
-    shortcut[0].music_id      = 0;    // 默认音乐ID
-    shortcut[0].timer_minutes = 10;   // 默认定时器时间
-
-    shortcut[1].heat_level    = 2;    // 55℃，默认档位
-    shortcut[1].music_id      = 2;    // 默认音乐ID
-    shortcut[1].timer_minutes = 30;   // 默认定时器时间
-
-    uint16_t reg_value1 = _compose_shortcut_data(&shortcut[0]);
-    uint16_t reg_value2 = _compose_shortcut_data(&shortcut[1]);
-    register_set_value(REG_SHORTCUT_KEY1, reg_value1);   // 保存快捷键1到寄存器
-    register_set_value(REG_SHORTCUT_KEY2, reg_value2);   // 保存快捷键2到寄存器
+    static const Shortcut_struct defaults[SHORTCUT_COUNT] = {
+        {0, 0, 10},   // 35℃，默认音乐，10分钟
+        {2, 2, 30},   // 55℃，音乐2，30分钟
+    };
+    if (index >= SHORTCUT_COUNT) return 0;
+    Shortcut_struct value = defaults[index];
+    return _compose_shortcut_data(&value);
 }
 static uint16_t _compose_shortcut_data(Shortcut_struct* shortcut)
 {
@@ -71,18 +67,29 @@ static void _parse_shortcut_data(uint16_t reg_value, Shortcut_struct* shortcut)
     // 定时时间（位8-15）: 右移8位后取低8位
     shortcut->timer_minutes = (reg_value >> 8) & 0xFF;
 }
-// 辅助函数：保存单个快捷键
-static void _save_single_shortcut(uint8_t index)
+// 音乐ID查询完成：写入快捷键寄存器
+static void _save_music_done(uint8_t music_id, void* arg)
 {
-    shortcut[index].heat_level    = register_get_value(REG_HEATING_LEVEL);   // 获取当前热敷档位
-    shortcut[index].music_id      = query_music_id();                        // 获取当前音乐ID
-    shortcut[index].timer_minutes = register_get_value(REG_HEATING_TIMER);   // 获取当前定时时间
+    uint8_t index            = (uint8_t)(uintptr_t)arg;
+    shortcut[index].music_id = music_id;
 
     uint16_t reg_value = _compose_shortcut_data(&shortcut[index]);   // 组合快捷键数据到寄存器值并保存到寄存器
 
     register_set_value((RegisterID)(REG_SHORTCUT_KEY1 + index), reg_value);   // 动态计算寄存器地址
 }
 
+// 辅助函数：保存单个快捷键，音乐ID异步查询，应答后保存
+static void _save_single_shortcut(uint8_t index)
+{
+    shortcut[index].heat_level    = register_get_value(REG_HEATING_LEVEL);   // 获取当前热敷档位
+    shortcut[index].timer_minutes = register_get_value(REG_HEATING_TIMER);   // 获取当前定时时间
+
+    if (!query_music_id(_save_music_done, (void*)(uintptr_t)index))   // 获取当前音乐ID
+    {
+        _save_music_done(MUSIC_ID_DEFAULT, (void*)(uintptr_t)index);   // 无法入队：按默认音乐保存
+    }
+}
+
 // 辅助函数：执行单个快捷键
 static void _execute_single_shortcut(uint8_t index)
 {
@@ -92,13 +99,17 @@ static void _execute_single_shortcut(uint8_t index)
     {
         mode_control(MUSIC_MODE);
     }
-    HAL_Delay(10);
     AT_PRINTF("AT+AB/%d\r\n", shortcut[index].music_id);                    // 播放指定序号音乐
     register_set_value(REG_HEATING_LEVEL, shortcut[index].heat_level);      //  设置热敷档位
     register_set_value(REG_HEATING_TIMER, shortcut[index].timer_minutes);   //  设置定时时间
     register_set_value(REG_HEATING_STATUS, 1);                              //  设置加热状态
 }
 
+static void _original_music_done(uint8_t music_id, void* arg)
+{
+    original_state.music_id = music_id;
+}
+
 // 保存快捷键
 void save_shortcut(uint8_t shortcut_id)
 {
@@ -152,8 +163,11 @@ void execute_shortcut_keys(uint8_t id)
     original_state.timer_minutes  = register_get_value(REG_HEATING_TIMER);
     original_state.heating_status = register_get_value(REG_HEATING_STATUS);
     original_state.music_playing  = led_get(LED_MUSIC);
-    original_state.music_id       = query_music_id();
+    original_state.music_id       = MUSIC_ID_DEFAULT;
     active_shortcut_id            = id;   // 更新激活的快捷键ID
 
+    // 查询先于快捷键的播放指令入队，应答为切换前的音乐ID
+    query_music_id(_original_music_done, NULL);
+
     _execute_single_shortcut(id - 1);   // 转换为数组索引
 }
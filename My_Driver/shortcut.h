@@ -11,6 +11,6 @@ extern Shortcut_struct shortcut[2];
 
 int8_t reset_act_shortcut_id(int8_t id);
 
-void shortcut_init(void);
+uint16_t shortcut_default_value(uint8_t index);
 void save_shortcut(uint8_t shortcut_id);
 void execute_shortcut_keys(uint8_t id);
@@ -0,0 +1,107 @@
+#include "fake_flash.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#ifndef MAP_FIXED_NOREPLACE
+#    define MAP_FIXED_NOREPLACE 0x100000
+#endif
+
+jmp_buf fake_flash_power_loss;
+uint32_t fake_flash_erases     = 0;
+uint32_t fake_flash_ops        = 0;
+uint32_t fake_flash_erase_op   = 0;
+uint32_t fake_flash_erase_cuts = 0;
+
+static int32_t _CutAfter = -1;   // 剩余操作次数，到 0 时掉电
+
+static uint8_t* _at(uint32_t addr)
+{
+    return (uint8_t*)(uintptr_t)addr;
+}
+
+// 本次操作是否被掉电打断
+static int _power_fails(void)
+{
+    fake_flash_ops++;
+    if (_CutAfter < 0) return 0;
+    return _CutAfter-- == 0;
+}
+
+void fake_flash_init(void)
+{
+    void* base = mmap((void*)(uintptr_t)FAKE_FLASH_BASE, FAKE_FLASH_SIZE, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+    if (base != (void*)(uintptr_t)FAKE_FLASH_BASE)
+    {
+        fprintf(stderr, "fake_flash: cannot map 0x%08X\n", FAKE_FLASH_BASE);
+        exit(1);
+    }
+    memset(base, 0xFF, FAKE_FLASH_SIZE);
+}
+
+void fake_flash_cut(int32_t ops)
+{
+    _CutAfter = ops;
+}
+
+FlashStatus flash_erase_page(uint32_t addr)
+{
+    uint8_t* page       = _at(addr & FLASH_ERASE_ADDR_MASK);
+    bool fails          = _power_fails();
+    fake_flash_erase_op = fake_flash_ops;
+    if (fails)
+    {
+        // 擦除中途掉电：部分半字已擦除
+        for (uint32_t i = 0; i < FLASH_ERASE_SIZE; i += 2)
+        {
+            if (rand() & 1) memset(page + i, 0xFF, 2);
+        }
+        fake_flash_erase_cuts++;
+        longjmp(fake_flash_power_loss, 1);
+    }
+    memset(page, 0xFF, FLASH_ERASE_SIZE);
+    fake_flash_erases++;
+    return FLASH_OK;
+}
+
+FlashStatus flash_program(uint32_t addr, const uint8_t* buffer, uint32_t bufferLen)
+{
+    if ((addr % 2) != 0) return FLASH_ADDR_ALIGN_ERR;
+
+    for (uint32_t cnt = 0; cnt < bufferLen; cnt += 2)
+    {
+        uint16_t data = buffer[cnt] | ((cnt + 1 < bufferLen) ? buffer[cnt + 1] << 8 : 0xFF00);
+        uint16_t old;
+        memcpy(&old, _at(addr + cnt), sizeof(old));
+        if (old != 0xFFFF && data != 0) return FLASH_WRITE_ERR;   // PGERR
+
+        if (_power_fails())
+        {
+            // 编程中途掉电：只有部分位被清零
+            uint16_t partial = old & (data | (uint16_t)rand());
+            memcpy(_at(addr + cnt), &partial, sizeof(partial));
+            longjmp(fake_flash_power_loss, 1);
+        }
+        uint16_t value = old & data;
+        memcpy(_at(addr + cnt), &value, sizeof(value));
+    }
+    return FLASH_OK;
+}
+
+FlashStatus flash_write(uint32_t addr, const uint8_t* buffer, uint32_t bufferLen)
+{
+    uint32_t end_page_addr = (addr + bufferLen - 1) & FLASH_ERASE_ADDR_MASK;
+    for (uint32_t page = addr & FLASH_ERASE_ADDR_MASK; page <= end_page_addr; page += FLASH_ERASE_SIZE)
+    {
+        if (flash_erase_page(page) != FLASH_OK) return FLASH_ERASE_ERR;
+    }
+    return flash_program(addr, buffer, bufferLen);
+}
+
+void flash_read(uint32_t addr, uint8_t* buffer, uint32_t bufferLen)
+{
+    memcpy(buffer, _at(addr), bufferLen);
+}
@@ -0,0 +1,28 @@
+#ifndef __FAKE_FLASH_H
+#define __FAKE_FLASH_H
+
+#include "flash.h"
+#include <setjmp.h>
+#include <stdint.h>
+
+/*
+ * 主机测试用的 NOR Flash 替身，实现 flash.h 的接口。
+ * - 在 0x08000000 处映射 64KB 内存，驱动中按地址直接读取 Flash 的代码无需修改。
+ * - 按 STM32F1 的规则：擦除以页为单位置 0xFF；半字编程的目标不是 0xFFFF 时（写 0 除外）返回错误。
+ * - fake_flash_cut(n) 模拟掉电：第 n 次半字编程或页擦除只完成一部分，然后 longjmp 到 fake_flash_power_loss。
+ */
+#define FAKE_FLASH_BASE 0x08000000u
+#define FAKE_FLASH_SIZE (64u * 1024u)
+
+extern jmp_buf fake_flash_power_loss;
+extern uint32_t fake_flash_erases;       // 累计页擦除次数
+extern uint32_t fake_flash_ops;          // 累计半字编程与页擦除次数，每次操作前加1
+extern uint32_t fake_flash_erase_op;     // 最近一次页擦除时的 fake_flash_ops
+extern uint32_t fake_flash_erase_cuts;   // 掉电发生在页擦除中的次数
+
+// 映射并擦除整片 Flash，映射失败时退出进程
+void fake_flash_init(void);
+// n 次操作后掉电，n < 0 时取消
+void fake_flash_cut(int32_t ops);
+
+#endif   // __FAKE_FLASH_H
@@ -0,0 +1,9 @@
+#ifndef __ADC_H__
+#define __ADC_H__
+
+// 主机测试用的 adc.h 替身
+#include "main.h"
+
+extern ADC_HandleTypeDef hadc1;
+
+#endif
@@ -0,0 +1,7 @@
+#ifndef __GPIO_H__
+#define __GPIO_H__
+
+// 主机测试用的 gpio.h 替身
+#include "main.h"
+
+#endif
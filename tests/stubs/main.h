@@ -0,0 +1,16 @@
+#ifndef __MAIN_H
+#define __MAIN_H
+
+// 主机测试用的 main.h 替身
+#include "stm32f1xx_hal.h"
+#include <stdbool.h>
+
+#ifndef RAMFUNC_ENABLE
+#define RAMFUNC_ENABLE 0
+#endif
+#define RAMFUNC
+
+void Error_Handler(void);
+void SystemClock_Config(void);
+
+#endif   // __MAIN_H
@@ -0,0 +1,7 @@
+#ifndef __RTC_H__
+#define __RTC_H__
+
+// 主机测试用的 rtc.h 替身
+#include "main.h"
+
+#endif
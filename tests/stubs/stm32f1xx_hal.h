@@ -0,0 +1,113 @@
+#ifndef __STM32F1xx_HAL_H
+#define __STM32F1xx_HAL_H
+
+/*
+ * 主机测试用的 HAL 替身：只提供被测源文件用到的类型、常量和函数声明。
+ * 函数由各测试按需实现（虚拟时钟、模拟外设），未用到的不必实现。
+ */
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define __IO volatile
+
+typedef enum
+{
+    HAL_OK = 0,
+    HAL_ERROR,
+    HAL_BUSY,
+    HAL_TIMEOUT
+} HAL_StatusTypeDef;
+
+typedef struct
+{
+    int Instance;
+} UART_HandleTypeDef;
+
+typedef struct
+{
+    int Instance;
+} ADC_HandleTypeDef;
+
+typedef struct
+{
+    int Instance;
+    uint32_t CCR[4];   // 各通道比较值，代替 TIMx->CCR1~CCR4
+} TIM_HandleTypeDef;
+
+typedef enum
+{
+    TIM3_IRQn      = 29,
+    RTC_Alarm_IRQn = 41,
+} IRQn_Type;
+
+// NVIC 与 FLASH 寄存器：只保留用到的字段，实例由测试定义
+typedef struct
+{
+    __IO uint32_t ISER[8];
+    uint32_t RESERVED0[24];
+    __IO uint32_t ICER[8];
+} NVIC_Type;
+
+typedef struct
+{
+    __IO uint32_t ACR;
+    __IO uint32_t KEYR;
+    __IO uint32_t OPTKEYR;
+    __IO uint32_t SR;
+    __IO uint32_t CR;
+    __IO uint32_t AR;
+} FLASH_TypeDef;
+
+extern NVIC_Type test_nvic;
+extern FLASH_TypeDef test_flash_regs;
+#define NVIC (&test_nvic)
+#define FLASH (&test_flash_regs)
+
+#ifdef FLASH_BUSY_HOOK
+uint32_t test_flash_busy(void);
+#define FLASH_SR_BSY test_flash_busy()   // 每次查询忙标志时调用，测试在此记录擦写进行中的寄存器状态
+#else
+#define FLASH_SR_BSY 0x00000001U
+#endif
+#define FLASH_SR_PGERR 0x00000004U
+#define FLASH_SR_WRPRTERR 0x00000010U
+#define FLASH_SR_EOP 0x00000020U
+#define FLASH_CR_PG 0x00000001U
+#define FLASH_CR_PER 0x00000002U
+#define FLASH_CR_STRT 0x00000040U
+#define FLASH_FLAG_PGERR FLASH_SR_PGERR
+#define FLASH_FLAG_WRPERR FLASH_SR_WRPRTERR
+#define FLASH_FLAG_EOP FLASH_SR_EOP
+#define __HAL_FLASH_CLEAR_FLAG(flag) (FLASH->SR &= ~(flag))   // 真实寄存器写1清零
+
+#define PWR_LOWPOWERREGULATOR_ON 0x00000001U
+#define PWR_STOPENTRY_WFI ((uint8_t)0x01)
+#define TIM_CHANNEL_4 0x0000000CU
+
+#define __HAL_TIM_SetCompare(__HANDLE__, __CHANNEL__, __COMPARE__) \
+    ((__HANDLE__)->CCR[(__CHANNEL__) >> 2U] = (__COMPARE__))
+
+extern __IO uint32_t uwTick;
+
+uint32_t HAL_GetTick(void);
+void HAL_SuspendTick(void);
+void HAL_ResumeTick(void);
+void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority);
+void HAL_NVIC_EnableIRQ(IRQn_Type IRQn);
+void HAL_PWR_EnterSTOPMode(uint32_t Regulator, uint8_t STOPEntry);
+void __WFI(void);
+HAL_StatusTypeDef HAL_FLASH_Unlock(void);
+HAL_StatusTypeDef HAL_FLASH_Lock(void);
+HAL_StatusTypeDef HAL_ADCEx_Calibration_Start(ADC_HandleTypeDef* hadc);
+HAL_StatusTypeDef HAL_ADC_Start_DMA(ADC_HandleTypeDef* hadc, uint32_t* pData, uint32_t Length);
+void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef* hadc);
+void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef* hadc);
+HAL_StatusTypeDef HAL_TIM_PWM_Start(TIM_HandleTypeDef* htim, uint32_t Channel);
+
+static inline void __disable_irq(void) {}
+static inline void __enable_irq(void) {}
+static inline void __DSB(void) {}
+static inline void __ISB(void) {}
+
+#endif   // __STM32F1xx_HAL_H
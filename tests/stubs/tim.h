@@ -0,0 +1,9 @@
+#ifndef __TIM_H__
+#define __TIM_H__
+
+// 主机测试用的 tim.h 替身
+#include "main.h"
+
+extern TIM_HandleTypeDef htim1;
+
+#endif
@@ -0,0 +1,167 @@
+// 启动流程：在虚拟时钟上运行真实的 boot.c 与 MultiTimer.c，检查阶段顺序、蓝牙上电等待下限与启动时间寄存器
+#include "MultiTimer.h"
+#include "boot.h"
+#include "register_interface.h"
+#include "test_common.h"
+#include <string.h>
+
+#define BOOT_AT_MS 20     // main() 调用 boot_start 的时刻（时钟配置与电源保持后的延时）
+#define AT_REPLY_MS 200   // 蓝牙配置指令全部应答所需的时间
+
+static uint64_t _Now = 0;   // 虚拟时钟，单位 ms，HAL_GetTick 与 MultiTimer 共用
+
+uint32_t HAL_GetTick(void)
+{
+    return (uint32_t)_Now;
+}
+
+static uint64_t virtual_ticks(void)
+{
+    return _Now;
+}
+
+/* ---------- 与 main.c 相同结构的阶段表，start 只记录调用顺序和时刻 ---------- */
+
+enum
+{
+    BOOT_CORE = 0,
+    BOOT_TASKS,
+    BOOT_BT_UART,
+    BOOT_BT_CONFIG,
+    BOOT_STAGES
+};
+
+static uint8_t _Order[8];
+static uint8_t _OrderCount = 0;
+static uint32_t _StartTick[BOOT_STAGES];
+static uint32_t _StartCalls[BOOT_STAGES];
+
+static void record_start(uint8_t stage)
+{
+    _Order[_OrderCount++] = stage;
+    _StartTick[stage]     = (uint32_t)_Now;
+    _StartCalls[stage]++;
+}
+
+static void core_start(void)
+{
+    record_start(BOOT_CORE);
+}
+
+static void tasks_start(void)
+{
+    CHECK(_StartCalls[BOOT_CORE] == 1);   // 依赖的阶段已完成
+    record_start(BOOT_TASKS);
+}
+
+static void uart_start(void)
+{
+    record_start(BOOT_BT_UART);
+}
+
+static void config_start(void)
+{
+    CHECK(_StartCalls[BOOT_BT_UART] == 1);
+    record_start(BOOT_BT_CONFIG);
+}
+
+// AT 引擎在配置开始 AT_REPLY_MS 后空闲
+static bool config_done(void)
+{
+    return _Now >= _StartTick[BOOT_BT_CONFIG] + AT_REPLY_MS;
+}
+
+static const BootStage _Stages[BOOT_STAGES] = {
+    [BOOT_CORE]      = {0, 0, core_start, NULL},
+    [BOOT_TASKS]     = {1u << BOOT_CORE, 0, tasks_start, NULL},
+    [BOOT_BT_UART]   = {1u << BOOT_CORE, 500, uart_start, NULL},
+    [BOOT_BT_CONFIG] = {1u << BOOT_BT_UART, 0, config_start, config_done},
+};
+
+static void reset(void)
+{
+    _OrderCount = 0;
+    memset(_StartTick, 0, sizeof(_StartTick));
+    memset(_StartCalls, 0, sizeof(_StartCalls));
+}
+
+// 每毫秒运行一次调度，直到启动完成或超时
+static void run_until_finished(uint32_t limit_ms)
+{
+    for (uint32_t i = 0; i < limit_ms && !boot_finished(); i++)
+    {
+        _Now++;
+        multiTimerYield();
+    }
+}
+
+static void test_main_table(void)
+{
+    reset();
+    _Now = BOOT_AT_MS;
+    boot_start(_Stages, BOOT_STAGES);
+
+    // 不需要等待的阶段在 boot_start 中按依赖顺序立即完成
+    CHECK(_OrderCount == 2);
+    CHECK(_Order[0] == BOOT_CORE && _Order[1] == BOOT_TASKS);
+    CHECK(boot_trace_get_register(BOOT_CORE) == BOOT_AT_MS);
+    CHECK(boot_trace_get_register(BOOT_TASKS) == BOOT_AT_MS);
+    CHECK(boot_trace_get_register(BOOT_BT_UART) == 0xFFFF);   // 尚未完成
+    CHECK(!boot_finished());
+
+    run_until_finished(2000);
+    CHECK(boot_finished());
+    CHECK(_OrderCount == BOOT_STAGES);
+    CHECK(_Order[2] == BOOT_BT_UART && _Order[3] == BOOT_BT_CONFIG);
+
+    // 蓝牙串口不早于上电后 500ms 启动，且不晚于下一次轮询
+    CHECK(_StartTick[BOOT_BT_UART] >= 500);
+    CHECK(_StartTick[BOOT_BT_UART] < 500 + BOOT_POLL_MS);
+    CHECK(_StartTick[BOOT_BT_CONFIG] == _StartTick[BOOT_BT_UART]);   // 同一次推进中解除依赖
+
+    // 等待完成条件的阶段只调用一次 start，完成时刻按轮询周期对齐
+    CHECK(_StartCalls[BOOT_BT_CONFIG] == 1);
+    uint16_t config_tick = boot_trace_get_register(BOOT_BT_CONFIG);
+    CHECK(config_tick >= _StartTick[BOOT_BT_CONFIG] + AT_REPLY_MS);
+    CHECK(config_tick < _StartTick[BOOT_BT_CONFIG] + AT_REPLY_MS + BOOT_POLL_MS);
+    CHECK(boot_trace_get_register(BOOT_BT_UART) == _StartTick[BOOT_BT_UART]);
+
+    // 表外的寄存器
+    CHECK(boot_trace_get_register(BOOT_STAGES) == 0xFFFF);
+    CHECK(boot_trace_get_register(REG_BOOT_TRACE_STAGES) == 0);
+
+    // 启动完成后轮询任务停止，阶段不再被调用
+    CHECK(multiTimerYield() == 0);
+    _Now += 1000;
+    multiTimerYield();
+    for (int i = 0; i < BOOT_STAGES; i++) CHECK(_StartCalls[i] == 1);
+
+    printf("boot trace: %u %u %u %u ms\n", boot_trace_get_register(BOOT_CORE), boot_trace_get_register(BOOT_TASKS),
+           boot_trace_get_register(BOOT_BT_UART), config_tick);
+}
+
+// 依赖指向表中靠后的阶段：重复扫描，仍在 boot_start 中全部完成
+static void test_reverse_dependencies(void)
+{
+    static const BootStage stages[3] = {
+        {1u << 1, 0, core_start, NULL},
+        {1u << 2, 0, tasks_start, NULL},
+        {0, 0, uart_start, NULL},
+    };
+
+    reset();
+    _StartCalls[BOOT_CORE] = 1;   // tasks_start 检查的前提在此不适用
+    boot_start(stages, 3);
+    CHECK(boot_finished());
+    CHECK(_OrderCount == 3);
+    CHECK(_Order[0] == BOOT_BT_UART && _Order[1] == BOOT_TASKS && _Order[2] == BOOT_CORE);
+    CHECK(multiTimerYield() == 0);   // 没有需要等待的阶段，不启动轮询任务
+}
+
+int main(void)
+{
+    multiTimerInstall(virtual_ticks);
+    test_main_table();
+    test_reverse_dependencies();
+    return test_result("test_boot");
+}
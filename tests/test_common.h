@@ -0,0 +1,37 @@
+#ifndef __TEST_COMMON_H
+#define __TEST_COMMON_H
+
+#include <stdio.h>
+#include <time.h>
+
+/*
+ * 主机测试的公共工具：CHECK 失败时打印位置并计数，main 返回 test_result() 作为进程退出码。
+ * 基准用单调时钟计时，结果为主机上的纳秒数，只用于比较同一台机器上的不同实现。
+ */
+static int test_failures = 0;
+
+#define CHECK(cond)                                                                    \
+    do                                                                                 \
+    {                                                                                  \
+        if (!(cond))                                                                   \
+        {                                                                              \
+            fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond);   \
+            test_failures++;                                                           \
+        }                                                                              \
+    } while (0)
+
+static inline double test_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static inline int test_result(const char* name)
+{
+    if (test_failures) fprintf(stderr, "%s: %d check(s) failed\n", name, test_failures);
+    else printf("%s: ok\n", name);
+    return test_failures ? 1 : 0;
+}
+
+#endif   // __TEST_COMMON_H
@@ -0,0 +1,173 @@
+// 配置记录：在 NOR Flash 替身上运行真实的 kv_store.c 与 register_interface.c，检查开机读取与校验失败、版本不符时的回退
+#include "MultiTimer.h"
+#include "alarm.h"
+#include "autotune.h"
+#include "boot.h"
+#include "bt401.h"
+#include "fake_flash.h"
+#include "hardware_register.h"
+#include "kv_store.h"
+#include "persist.h"
+#include "register_interface.h"
+#include "shortcut.h"
+#include "test_common.h"
+#include <string.h>
+
+#define DEFAULT_KEY1 0x0A00   // 替身返回的快捷键默认值
+#define DEFAULT_KEY2 0x1E02
+#define RECORD_VALUE (FLASH_KV_ADDR + 4 + 2)   // 空白存储区中第一条记录的值：页头(4) + 记录头(2)
+
+// 与 register_interface.c 中的 ConfigBlob 布局一致
+typedef struct
+{
+    uint8_t version;
+    uint8_t reserved;
+    uint16_t shortcut[2];
+} Blob;
+
+static uint32_t _Marks = 0;   // persist_mark(PERSIST_CONFIG) 的次数
+
+/* ---------- 依赖替身 ---------- */
+
+uint16_t shortcut_default_value(uint8_t index)
+{
+    return index ? DEFAULT_KEY2 : DEFAULT_KEY1;
+}
+
+void persist_mark(PersistDataset dataset)
+{
+    if (dataset == PERSIST_CONFIG) _Marks++;
+}
+
+uint16_t BT401_Printf(const char* format, ...)
+{
+    return 0;
+}
+
+void update_hardware_registers(const uint16_t* data, uint16_t num) {}
+void delete_alarm(uint8_t index) {}
+void execute_shortcut_keys(uint8_t id) {}
+void rf_switch(uint8_t state) {}
+void rf_level(uint8_t level) {}
+void rf_time(uint16_t min) {}
+void shutdown(void) {}
+void autotune_start(void) {}
+void autotune_abort(void) {}
+
+uint16_t multiTimerStatsRegister(uint16_t offset)
+{
+    return 0;
+}
+
+uint16_t boot_trace_get_register(uint16_t offset)
+{
+    return 0;
+}
+
+/* ---------- 测试 ---------- */
+
+// 清空存储区后写入一条配置记录（len 为 0 时不写），然后重新挂载并开机读取
+static void boot_with_record(const void* record, uint8_t len)
+{
+    memset((void*)(uintptr_t)FLASH_KV_ADDR, 0xFF, FLASH_KV_PAGES * FLASH_ERASE_SIZE);
+    kv_init();
+    if (len) CHECK(kv_write(KV_KEY_CONFIG, record, len) == FLASH_OK);
+    kv_init();
+    _Marks = 0;
+    register_interface_init();
+}
+
+static void check_shortcuts(uint16_t key1, uint16_t key2)
+{
+    CHECK(register_get_value(REG_SHORTCUT_KEY1) == key1);
+    CHECK(register_get_value(REG_SHORTCUT_KEY2) == key2);
+}
+
+// 回退到默认值并标记写回一次；写回后下次开机只需读取，不再写回
+static void check_fallback(const char* name)
+{
+    check_shortcuts(DEFAULT_KEY1, DEFAULT_KEY2);
+    CHECK(_Marks == 1);
+
+    save_config();
+    kv_init();
+    _Marks = 0;
+    register_interface_init();
+    check_shortcuts(DEFAULT_KEY1, DEFAULT_KEY2);
+    CHECK(_Marks == 0);
+    printf("%s: defaults, written back once\n", name);
+}
+
+// 当前版本的记录：直接恢复，不写回；修改后重新挂载仍保持
+static void test_current(void)
+{
+    Blob blob = {1, 0, {0x1234, 0x5678}};
+    boot_with_record(&blob, sizeof(blob));
+    check_shortcuts(0x1234, 0x5678);
+    CHECK(_Marks == 0);
+
+    uint32_t ops = fake_flash_ops;
+    save_config();   // 与已保存的相同，不写 Flash
+    CHECK(fake_flash_ops == ops);
+
+    CHECK(register_set_value(REG_SHORTCUT_KEY2, 0x4321));
+    CHECK(_Marks == 1);
+    save_config();
+    kv_init();
+    register_interface_init();
+    check_shortcuts(0x1234, 0x4321);
+}
+
+static void test_blank(void)
+{
+    boot_with_record(NULL, 0);
+    check_fallback("blank");
+}
+
+// 记录CRC校验失败：kv_read 不返回该记录
+static void test_crc_rejected(void)
+{
+    Blob blob = {1, 0, {0x1234, 0x5678}};
+    memset((void*)(uintptr_t)FLASH_KV_ADDR, 0xFF, FLASH_KV_PAGES * FLASH_ERASE_SIZE);
+    kv_init();
+    CHECK(kv_write(KV_KEY_CONFIG, &blob, sizeof(blob)) == FLASH_OK);
+    CHECK(memcmp((const void*)(uintptr_t)RECORD_VALUE, &blob, sizeof(blob)) == 0);
+    *(uint8_t*)(uintptr_t)(RECORD_VALUE + 2) &= ~0x10;   // Flash 位翻转：快捷键1的一个位被清零
+    kv_init();
+    _Marks = 0;
+    register_interface_init();
+    check_fallback("crc rejected");
+}
+
+static void test_unknown_version(void)
+{
+    Blob future = {2, 0, {0x1234, 0x5678}};   // 更新的固件写入的记录（固件降级）
+    boot_with_record(&future, sizeof(future));
+    check_fallback("version 2");
+
+    Blob zero = {0, 0, {0x1234, 0x5678}};
+    boot_with_record(&zero, sizeof(zero));
+    check_fallback("version 0");
+}
+
+static void test_bad_length(void)
+{
+    Blob blob = {1, 0, {0x1234, 0x5678}};
+    boot_with_record(&blob, sizeof(blob) - 1);   // 短记录：版本号正确但缺少字段
+    check_fallback("short record");
+
+    uint8_t longer[sizeof(Blob) + 2] = {1, 0, 0x34, 0x12, 0x78, 0x56, 0, 0};
+    boot_with_record(longer, sizeof(longer));
+    check_fallback("long record");
+}
+
+int main(void)
+{
+    fake_flash_init();
+    test_current();
+    test_blank();
+    test_crc_rejected();
+    test_unknown_version();
+    test_bad_length();
+    return test_result("test_config");
+}
@@ -0,0 +1,129 @@
+// Flash 擦写例程（RAMFUNC_ENABLE = 1）：在寄存器替身上检查擦写中的 NVIC 屏蔽、结束后的恢复、CR/AR 的设置与写入的数据
+#include "flash.h"
+#include "main.h"
+#include "test_common.h"
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#ifndef MAP_FIXED_NOREPLACE
+#    define MAP_FIXED_NOREPLACE 0x100000
+#endif
+
+#define FLASH_BASE 0x08000000u
+#define FLASH_SIZE (64u * 1024u)
+#define ENABLED0 0xFFFFFFFFu   // 擦写前 ISER[0] 的使能位
+#define ENABLED1 0x000000FFu   // 擦写前 ISER[1] 的使能位（STM32F103 共 60 个中断）
+#define TIM3_BIT (1u << TIM3_IRQn)
+
+NVIC_Type test_nvic;
+FLASH_TypeDef test_flash_regs;
+
+typedef struct
+{
+    uint32_t polls;        // 本次操作查询忙标志的次数
+    uint32_t enabled[2];   // 查询忙标志时仍使能的中断：ISER 与 ICER 写入值按写1清零合成
+    uint32_t cr;
+    uint32_t ar;
+} BusySnapshot;
+
+static BusySnapshot _Busy;
+static uint32_t _Unlocked  = 0;   // HAL_FLASH_Unlock 与 HAL_FLASH_Lock 之差
+static uint32_t _FailAfter = 0;   // 非 0 时第 n 次查询忙标志置 PGERR，模拟编程错误
+
+HAL_StatusTypeDef HAL_FLASH_Unlock(void)
+{
+    _Unlocked++;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Lock(void)
+{
+    _Unlocked--;
+    return HAL_OK;
+}
+
+// 查询忙标志即擦写进行中：记录此刻的寄存器状态，返回的位在 SR 中为 0，只查询一次即结束
+uint32_t test_flash_busy(void)
+{
+    _Busy.polls++;
+    _Busy.enabled[0] = ENABLED0 & ~NVIC->ICER[0];
+    _Busy.enabled[1] = ENABLED1 & ~NVIC->ICER[1];
+    _Busy.cr         = FLASH->CR;
+    _Busy.ar         = FLASH->AR;
+    if (_FailAfter && --_FailAfter == 0) FLASH->SR |= FLASH_SR_PGERR;
+    return 0x1u;   // FLASH_SR_BSY
+}
+
+static void reset_registers(void)
+{
+    memset(&test_nvic, 0, sizeof(test_nvic));
+    memset(&test_flash_regs, 0, sizeof(test_flash_regs));
+    memset(&_Busy, 0, sizeof(_Busy));
+    NVIC->ISER[0] = ENABLED0;
+    NVIC->ISER[1] = ENABLED1;
+    FLASH->SR     = FLASH_SR_EOP | FLASH_SR_PGERR;   // 上一次操作遗留的标志，操作前应被清除
+}
+
+// 擦写进行中只有 TIM3 仍使能；结束后 ISER 恢复原值，CR 的操作位已清除，Flash 已上锁
+static void check_masked_and_restored(uint32_t polls, uint32_t op_bit)
+{
+    CHECK(_Busy.polls == polls);
+    CHECK(_Busy.enabled[0] == TIM3_BIT);
+    CHECK(_Busy.enabled[1] == 0);
+    CHECK(_Busy.cr & op_bit);
+    CHECK(NVIC->ISER[0] == ENABLED0);
+    CHECK(NVIC->ISER[1] == ENABLED1);
+    CHECK((FLASH->CR & (FLASH_CR_PER | FLASH_CR_PG)) == 0);
+    CHECK(_Unlocked == 0);
+}
+
+static void test_erase(void)
+{
+    reset_registers();
+    CHECK(flash_erase_page(FLASH_KV_ADDR + 0x123) == FLASH_OK);
+    check_masked_and_restored(1, FLASH_CR_PER);
+    CHECK(_Busy.cr & FLASH_CR_STRT);    // 启动擦除时 PER 已置位
+    CHECK(_Busy.ar == FLASH_KV_ADDR);   // 页对齐
+    CHECK(FLASH->AR == FLASH_KV_ADDR);
+}
+
+static void test_program(void)
+{
+    const uint8_t data[5] = {0x11, 0x22, 0x33, 0x44, 0x55};
+    uint8_t* target       = (uint8_t*)(uintptr_t)FLASH_KV_ADDR;
+    memset(target, 0xFF, FLASH_ERASE_SIZE);
+
+    reset_registers();
+    CHECK(flash_program(FLASH_KV_ADDR, data, sizeof(data)) == FLASH_OK);
+    check_masked_and_restored(3, FLASH_CR_PG);   // 3 个半字，每个半字单独屏蔽与恢复
+    CHECK(memcmp(target, data, sizeof(data)) == 0);
+    CHECK(target[5] == 0xFF);                    // 奇数长度补 0xFF
+}
+
+// 编程出错：返回错误，中断照常恢复，Flash 上锁
+static void test_program_error(void)
+{
+    const uint8_t data[4] = {0xA5, 0x5A, 0x0F, 0xF0};
+    reset_registers();
+    _FailAfter = 2;
+    CHECK(flash_program(FLASH_KV_ADDR + 16, data, sizeof(data)) == FLASH_WRITE_ERR);
+    check_masked_and_restored(2, FLASH_CR_PG);
+}
+
+int main(void)
+{
+    // 整片 64KB Flash 映射在真实地址（mmap 须按主机页对齐），驱动按 32 位地址访问
+    void* base = mmap((void*)(uintptr_t)FLASH_BASE, FLASH_SIZE, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+    if (base != (void*)(uintptr_t)FLASH_BASE)
+    {
+        fprintf(stderr, "test_flash: cannot map 0x%08X\n", FLASH_BASE);
+        return 1;
+    }
+
+    test_erase();
+    test_program();
+    test_program_error();
+    return test_result("test_flash");
+}
@@ -0,0 +1,257 @@
+// 加热器闭环仿真：热容 + 散热 + NTC 滞后 + ADC 噪声的对象模型，驱动真实的 ntc.c、pid.c、autotune.c
+#include "autotune.h"
+#include "kv_store.h"
+#include "led.h"
+#include "ntc.h"
+#include "persist.h"
+#include "register_interface.h"
+#include "test_common.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * 对象模型（1ms 步长）：
+ * - 加热功率 P_MAX × 占空比（TIM1 CH4 比较值，0~100），热容 HEAT_CAPACITY，对环境热阻 HEAT_RESISTANCE。
+ * - NTC 以时间常数 NTC_TAU_S 跟随加热面，读数比加热面低 SENSOR_OFFSET_C（对应 NTC_control 中的 +2℃ 补偿）。
+ * - 10kΩ/B3950 NTC 与 10kΩ 分压，ADC 噪声 ADC_NOISE_LSB（均方根）。
+ * - 每 64ms 写满半个 DMA 缓冲并调用半满/全满回调，每秒调用一次 NTC_control，与固件的节拍相同。
+ * 参数是估计值，不代表实物；用于比较控制策略，并检查整定流程和控温指标没有退化。
+ */
+#define P_MAX 10.0              // 加热功率（W）
+#define HEAT_CAPACITY 200.0     // 热容（J/K）
+#define HEAT_RESISTANCE 4.0     // 对环境热阻（K/W）
+#define NTC_TAU_S 15.0          // NTC 与加热面之间的热滞后（s）
+#define SENSOR_OFFSET_C 2.0     // NTC 读数偏低
+#define ADC_NOISE_LSB 2.0       // ADC 噪声（码值，均方根）
+#define ADC_BLOCK_SAMPLES 64    // 与 ntc.c 相同：每半缓冲的采样数，1kHz 触发
+#define CONTROL_MS 1000         // 控温周期
+#define SETTLE_BAND_C 0.5       // 稳定判据
+#define SCENARIO_S (2 * 3600)   // 每个控温场景的时长
+
+ADC_HandleTypeDef hadc1;
+TIM_HandleTypeDef htim1;
+extern PID_Controller heater_pid;   // ntc.c
+
+static uint32_t _Tick       = 0;       // HAL_GetTick，整个测试中单调递增
+static uint32_t* _DmaBuffer = NULL;    // HAL_ADC_Start_DMA 交给 DMA 的缓冲区
+static bool _DmaHalf        = false;   // 下一次写后半缓冲
+static double _Ambient      = 25.0;    // 环境温度
+static double _HeaterC      = 25.0;    // 加热面温度
+static double _NtcC         = 25.0;    // NTC 温度
+
+static uint16_t _Registers[REG_COUNT];        // 寄存器表
+static uint8_t _KvTuning[KV_MAX_VALUE_LEN];   // 存储区中的整定记录
+static uint8_t _KvTuningLen = 0;              // 整定记录长度，0 表示没有
+static uint32_t _KvWrites   = 0;              // 整定记录写入次数
+static uint32_t _Overheats  = 0;              // 过热报警次数
+
+/* ---------- HAL 与驱动的替身 ---------- */
+
+uint32_t HAL_GetTick(void)
+{
+    return _Tick;
+}
+
+HAL_StatusTypeDef HAL_ADCEx_Calibration_Start(ADC_HandleTypeDef* hadc)
+{
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADC_Start_DMA(ADC_HandleTypeDef* hadc, uint32_t* pData, uint32_t Length)
+{
+    CHECK(Length == 2 * ADC_BLOCK_SAMPLES);
+    _DmaBuffer = pData;
+    _DmaHalf   = false;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_PWM_Start(TIM_HandleTypeDef* htim, uint32_t Channel)
+{
+    return HAL_OK;
+}
+
+void led_set_mode(LED_Index idx, led_mode_t mode, uint32_t interval_ms)
+{
+    if (idx == LED_RF && mode == LED_MODE_BLINK) _Overheats++;
+}
+
+// 与 register_interface.c 相同：REG_AUTOTUNE 写1开始整定、写0取消
+bool register_set_value(RegisterID id, uint16_t value)
+{
+    if (_Registers[id] == value) return false;
+    _Registers[id] = value;
+    if (id == REG_AUTOTUNE)
+    {
+        if (value == AUTOTUNE_RUNNING) autotune_start();
+        else if (value == AUTOTUNE_IDLE) autotune_abort();
+    }
+    return true;
+}
+
+uint16_t register_get_value(RegisterID id)
+{
+    return _Registers[id];
+}
+
+uint8_t kv_read(KvKey key, void* buffer, uint8_t size)
+{
+    if (key != KV_KEY_TUNING) return 0;
+    memcpy(buffer, _KvTuning, size < _KvTuningLen ? size : _KvTuningLen);
+    return _KvTuningLen;
+}
+
+FlashStatus kv_write(KvKey key, const void* data, uint8_t len)
+{
+    CHECK(key == KV_KEY_TUNING && len <= KV_MAX_VALUE_LEN);
+    memcpy(_KvTuning, data, len);
+    _KvTuningLen = len;
+    _KvWrites++;
+    return FLASH_OK;
+}
+
+// 不模拟延迟写入，标记后立即保存
+void persist_mark(PersistDataset dataset)
+{
+    CHECK(dataset == PERSIST_TUNING);
+    autotune_save();
+}
+
+/* ---------- 对象模型 ---------- */
+
+static double gauss(void)
+{
+    double u = (rand() + 1.0) / (RAND_MAX + 2.0);
+    double v = (rand() + 1.0) / (RAND_MAX + 2.0);
+    return sqrt(-2.0 * log(u)) * cos(2.0 * M_PI * v);
+}
+
+static uint16_t adc_code(double temp)
+{
+    double r    = 10000.0 * exp(3950.0 * (1.0 / (temp + 273.15) - 1.0 / 298.15));
+    double code = 4095.0 * r / (r + 10000.0) + gauss() * ADC_NOISE_LSB;
+    if (code < 0) return 0;
+    if (code > 4095) return 4095;
+    return (uint16_t)(code + 0.5);
+}
+
+typedef struct
+{
+    const char* name;
+    int target;             // 设定温度（℃）
+    double peak;            // 最高温度
+    uint32_t settle_s;      // 最后一次超出 ±SETTLE_BAND_C 的时刻（s）
+    double error_sum;       // 后半段的温度误差之和
+    uint32_t error_count;   // 后半段的控温周期数
+    uint32_t steps;         // NTC_control 调用次数
+    double control_ns;      // NTC_control 的主机耗时
+} Metrics;
+
+// 推进 ms 毫秒：更新温度，按节拍产生 ADC 块和控温周期
+static void simulate(uint32_t ms, Metrics* metrics)
+{
+    for (uint32_t i = 0; i < ms; i++)
+    {
+        uint32_t duty = htim1.CCR[TIM_CHANNEL_4 >> 2];
+        CHECK(duty <= 100);
+        double power = P_MAX * duty / 100.0;
+        _HeaterC += (power - (_HeaterC - _Ambient) / HEAT_RESISTANCE) / HEAT_CAPACITY * 1e-3;
+        _NtcC += (_HeaterC - _NtcC) / NTC_TAU_S * 1e-3;
+        _Tick++;
+
+        if (_Tick % ADC_BLOCK_SAMPLES == 0)
+        {
+            uint16_t* block = (uint16_t*)_DmaBuffer + (_DmaHalf ? ADC_BLOCK_SAMPLES : 0);
+            for (int k = 0; k < ADC_BLOCK_SAMPLES; k++) block[k] = adc_code(_NtcC - SENSOR_OFFSET_C);
+            if (_DmaHalf) HAL_ADC_ConvCpltCallback(&hadc1);
+            else HAL_ADC_ConvHalfCpltCallback(&hadc1);
+            _DmaHalf = !_DmaHalf;
+        }
+
+        if (_Tick % CONTROL_MS == 0)
+        {
+            double start = test_now_ns();
+            NTC_control(CONTROL_MS);
+            if (!metrics) continue;
+            metrics->control_ns += test_now_ns() - start;
+            metrics->steps++;
+
+            double error = _HeaterC - metrics->target;
+            if (_HeaterC > metrics->peak) metrics->peak = _HeaterC;
+            if (fabs(error) > SETTLE_BAND_C) metrics->settle_s = metrics->steps;
+            if (metrics->steps > SCENARIO_S / 2)
+            {
+                metrics->error_sum += error;
+                metrics->error_count++;
+            }
+        }
+    }
+}
+
+// 从环境温度开始上电，加热前先关闭加热跑几个控温周期，让中位数窗口采满并复位加热起始温度
+static void power_on(double ambient, int target)
+{
+    _Ambient = _HeaterC = _NtcC = ambient;
+    register_set_value(REG_HEATING_STATUS, 0);
+    Temp_init();
+    set_target_temperature(target);
+    simulate(2 * CONTROL_MS, NULL);
+}
+
+static Metrics run_scenario(const char* name, double ambient, int target)
+{
+    Metrics metrics = {.name = name, .target = target, .peak = ambient};
+    power_on(ambient, target);
+    register_set_value(REG_HEATING_STATUS, 1);
+    simulate(SCENARIO_S * 1000u, &metrics);
+
+    double overshoot = metrics.peak - target;
+    double ss_error  = metrics.error_sum / metrics.error_count;
+    printf("%-22s overshoot %5.2f C, settled (±%.1f C) after %4u s, steady-state error %+5.2f C, %5.0f ns/step\n",
+           name, overshoot, SETTLE_BAND_C, metrics.settle_s, ss_error, metrics.control_ns / metrics.steps);
+    CHECK(metrics.settle_s < SCENARIO_S / 2);   // 后半段始终在稳定带内
+    CHECK(fabs(ss_error) < 0.2);
+    return metrics;
+}
+
+static void run_autotune(void)
+{
+    uint32_t writes = _KvWrites;
+    power_on(25.0, 40);
+    register_set_value(REG_AUTOTUNE, AUTOTUNE_RUNNING);
+    CHECK(autotune_active());
+
+    uint32_t start = _Tick;
+    while (register_get_value(REG_AUTOTUNE) == AUTOTUNE_RUNNING && _Tick - start < AUTOTUNE_TIMEOUT_S * 1000u)
+    {
+        simulate(CONTROL_MS, NULL);
+    }
+    CHECK(register_get_value(REG_AUTOTUNE) == AUTOTUNE_DONE);
+    CHECK(_KvWrites == writes + 1);   // 结果已保存
+    printf("autotune done after %u s: Kp %.2f, Ki %.4f, Kd %.1f (plant gain %.2f C/%%)\n", (_Tick - start) / 1000,
+           heater_pid.Kp / 65536.0, heater_pid.Ki / 65536.0, heater_pid.Kd / 65536.0, P_MAX * HEAT_RESISTANCE / 100);
+
+    // 重新上电从存储区加载同一组参数
+    PID_Controller tuned = heater_pid;
+    Temp_init();
+    CHECK(heater_pid.Kp == tuned.Kp && heater_pid.Ki == tuned.Ki && heater_pid.Kd == tuned.Kd);
+}
+
+int main(void)
+{
+    srand(1);
+    Metrics initial = run_scenario("default gains", 25.0, 40);
+    CHECK(initial.peak - initial.target < 1.0);
+
+    run_autotune();
+    Metrics tuned = run_scenario("tuned + feed-forward", 25.0, 40);
+    CHECK(tuned.peak - tuned.target < 0.5);
+    CHECK(tuned.settle_s < initial.settle_s);
+
+    Metrics cold = run_scenario("tuned, ambient 15C", 15.0, 45);
+    CHECK(cold.peak - cold.target < 0.5);
+
+    CHECK(_Overheats == 0);
+    CHECK(!is_overheat());
+    return test_result("test_heater");
+}
@@ -0,0 +1,149 @@
+// 键值存储：在 NOR Flash 替身上随机写入并反复重新挂载，检查读回的值；写入中途随机掉电时只影响正在写的键
+#include "fake_flash.h"
+#include "kv_store.h"
+#include "test_common.h"
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define RANDOM_WRITES 20000
+#define POWER_LOSS_TRIALS 3000
+
+typedef struct
+{
+    uint8_t len;   // 0 表示从未写入
+    uint8_t value[KV_MAX_VALUE_LEN];
+} Expected;
+
+static Expected _Expected[KV_KEY_COUNT];
+
+static void random_value(Expected* entry)
+{
+    entry->len = 1 + rand() % KV_MAX_VALUE_LEN;
+    for (uint8_t i = 0; i < entry->len; i++) entry->value[i] = rand();
+}
+
+static int key_matches(KvKey key, const Expected* entry)
+{
+    uint8_t buffer[KV_MAX_VALUE_LEN];
+    uint8_t len = kv_read(key, buffer, sizeof(buffer));
+    return len == entry->len && memcmp(buffer, entry->value, len) == 0;
+}
+
+static uint32_t check_all(void)
+{
+    uint32_t mismatches = 0;
+    for (int key = 0; key < KV_KEY_COUNT; key++)
+    {
+        if (!key_matches((KvKey)key, &_Expected[key])) mismatches++;
+    }
+    return mismatches;
+}
+
+static void test_random_writes(void)
+{
+    uint32_t mismatches = 0;
+    uint32_t erases     = fake_flash_erases;
+
+    for (int i = 0; i < RANDOM_WRITES; i++)
+    {
+        int key = rand() % KV_KEY_COUNT;
+        Expected entry;
+        random_value(&entry);
+        if (rand() % 4 == 0 && _Expected[key].len) entry = _Expected[key];   // 写入相同的值
+        CHECK(kv_write((KvKey)key, entry.value, entry.len) == FLASH_OK);
+        _Expected[key] = entry;
+
+        if (i % 97 == 0) kv_init();   // 重新挂载，索引从 Flash 重建
+        mismatches += check_all();
+    }
+    CHECK(mismatches == 0);
+    printf("random writes: %d writes, %u mismatches, %u page erases\n", RANDOM_WRITES, mismatches,
+           fake_flash_erases - erases);
+}
+
+// 相同的值不写入 Flash
+static void test_unchanged(void)
+{
+    uint8_t before[FLASH_KV_PAGES * FLASH_ERASE_SIZE];
+    memcpy(before, (const void*)(uintptr_t)FLASH_KV_ADDR, sizeof(before));
+    for (int key = 0; key < KV_KEY_COUNT; key++)
+    {
+        CHECK(kv_write((KvKey)key, _Expected[key].value, _Expected[key].len) == FLASH_OK);
+    }
+    CHECK(memcmp(before, (const void*)(uintptr_t)FLASH_KV_ADDR, sizeof(before)) == 0);
+}
+
+static void test_power_loss(void)
+{
+    static uint8_t snapshot[FLASH_KV_PAGES * FLASH_ERASE_SIZE];
+    uint8_t* store = (uint8_t*)(uintptr_t)FLASH_KV_ADDR;
+    uint32_t kept  = 0;
+    uint32_t bad   = 0;
+
+    for (int trial = 0; trial < POWER_LOSS_TRIALS; trial++)
+    {
+        int key = rand() % KV_KEY_COUNT;
+        Expected entry;
+        random_value(&entry);
+
+        // 先完整写一次统计这次写入的 Flash 操作数（含换页回收），恢复后在其中任意一次操作时掉电；
+        // 换页时有一半的机会掉电在擦除最旧页时
+        memcpy(snapshot, store, sizeof(snapshot));
+        uint32_t start = fake_flash_ops;
+        kv_write((KvKey)key, entry.value, entry.len);
+        uint32_t ops = fake_flash_ops - start;
+        bool erased  = fake_flash_erase_op > start;
+        uint32_t cut = (erased && rand() % 2) ? fake_flash_erase_op - start - 1 : rand() % (ops ? ops : 1);
+        memcpy(store, snapshot, sizeof(snapshot));
+        kv_init();
+        if (ops == 0) continue;
+
+        fake_flash_cut(cut);
+        if (setjmp(fake_flash_power_loss) == 0)
+        {
+            kv_write((KvKey)key, entry.value, entry.len);
+            CHECK(0);   // 应在第 cut 次操作时掉电
+        }
+
+        // 重新上电：正在写的键为旧值或新值，其他键不受影响
+        fake_flash_cut(-1);
+        kv_init();
+        if (key_matches((KvKey)key, &_Expected[key]))
+        {
+            kept++;
+        } else if (key_matches((KvKey)key, &entry))
+        {
+            _Expected[key] = entry;
+        } else
+        {
+            bad++;
+        }
+        CHECK(check_all() == 0);
+
+        // 掉电后存储区仍可正常写入
+        random_value(&entry);
+        CHECK(kv_write((KvKey)key, entry.value, entry.len) == FLASH_OK);
+        _Expected[key] = entry;
+        CHECK(check_all() == 0);
+    }
+    CHECK(bad == 0);
+    CHECK(fake_flash_erase_cuts > 0);
+    printf("power loss: %d cuts (%u during a page erase), %u kept the old value, %u lost\n", POWER_LOSS_TRIALS,
+           fake_flash_erase_cuts, kept, bad);
+}
+
+int main(void)
+{
+    fake_flash_init();
+    srand(1);
+
+    kv_init();   // 空白 Flash：格式化
+    CHECK(check_all() == 0);
+    test_random_writes();
+    test_unchanged();
+    test_power_loss();
+    kv_init();
+    CHECK(check_all() == 0);
+    return test_result("test_kv_store");
+}
@@ -0,0 +1,196 @@
+// 空闲低功耗：在虚拟时钟上运行真实的 lowpower.c 与 MultiTimer.c，检查滴答补偿与任务延迟，并估算平均电流
+#include "MultiTimer.h"
+#include "lowpower.h"
+#include "main.h"
+#include "test_common.h"
+
+/*
+ * 时间模型（单位 µs）：TIM3 与 SysTick 在每个整毫秒边界各加 1，STOP 期间与唤醒后恢复时钟之前停止计数。
+ * - __WFI 睡到下一个整毫秒边界（1ms 滴答中断唤醒）。
+ * - HAL_PWR_EnterSTOPMode 睡到 RTC 闹钟的整秒，SystemClock_Config 再花 WAKE_US 等待 HSE 与 PLL。
+ * - 回调与一次 multiTimerYield 的执行时间取下表中的假设值，不代表实测结果。
+ * 电流为 STM32F103 数据手册 72MHz、外设时钟开启时的典型值，只用于比较不同空闲策略，不是实测功耗。
+ */
+#define RUN_MA 36.0f      // 运行
+#define SLEEP_MA 14.0f    // SLEEP
+#define STOP_MA 0.024f    // STOP，低功耗调压器
+#define YIELD_US 2        // 一次主循环（multiTimerYield 与 lowpower_idle）的开销
+#define WAKE_US 1500      // STOP 唤醒后 HSE 起振与 PLL 锁定
+
+volatile uint64_t platform_ticks = 0;
+__IO uint32_t uwTick             = 0;
+
+enum
+{
+    RUN = 0,
+    SLEEP,
+    STOP,
+    MODES
+};
+
+static uint64_t _RealUs        = 0;      // 真实时间
+static bool _TicksRunning      = true;   // TIM3 与 SysTick 是否在计数
+static uint64_t _ModeUs[MODES] = {0};
+static uint32_t _AlarmSec      = 0;
+static uint32_t _StopEntries   = 0;
+
+static void advance(uint64_t us, int mode)
+{
+    uint64_t end = _RealUs + us;
+    if (_TicksRunning)
+    {
+        uint64_t boundaries = end / 1000 - _RealUs / 1000;
+        platform_ticks += boundaries;
+        uwTick += (uint32_t)boundaries;
+    }
+    _RealUs = end;
+    _ModeUs[mode] += us;
+}
+
+static uint64_t virtual_ticks(void)
+{
+    return platform_ticks;
+}
+
+/* ---------- HAL 与驱动的替身 ---------- */
+
+void __WFI(void)
+{
+    advance(1000 - _RealUs % 1000, SLEEP);
+}
+
+void HAL_SuspendTick(void) {}
+void HAL_ResumeTick(void) {}
+void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority) {}
+void HAL_NVIC_EnableIRQ(IRQn_Type IRQn) {}
+
+void HAL_PWR_EnterSTOPMode(uint32_t Regulator, uint8_t STOPEntry)
+{
+    _StopEntries++;
+    _TicksRunning = false;
+    CHECK((uint64_t)_AlarmSec * 1000000 > _RealUs);   // 闹钟在将来
+    advance((uint64_t)_AlarmSec * 1000000 - _RealUs, STOP);
+}
+
+void SystemClock_Config(void)
+{
+    advance(WAKE_US, RUN);
+    _TicksRunning = true;
+}
+
+uint64_t read_rtc_ms(void)
+{
+    return _RealUs / 1000;
+}
+
+HAL_StatusTypeDef write_rtc_alarm(uint32_t alarm)
+{
+    _AlarmSec = alarm;
+    return HAL_OK;
+}
+
+bool is_heating_active(void)
+{
+    return false;
+}
+
+bool is_music_active(void)
+{
+    return false;
+}
+
+bool BT401_TxBusy(void)
+{
+    return false;
+}
+
+/* ---------- 任务 ---------- */
+
+typedef struct
+{
+    const char* name;
+    uint32_t period_ms;
+    uint32_t cost_us;   // 假设的单次执行时间
+} Task;
+
+#if LOWPOWER_USE_STOP
+// STOP 只在没有 1ms/1s 任务时才有机会进入，这里只保留慢速任务
+static const Task _Tasks[] = {
+    {"upload", 10000, 100},
+    {"night", 60000, 20},
+    {"report", 5000, 50},
+};
+#    define SIM_MS (3600u * 1000u)
+#else
+// 与 main.c 中的任务表相同的周期
+static const Task _Tasks[] = {
+    {"update", 1, 20},    {"protocol", 1, 5},   {"key", 20, 10},       {"ntc", 1000, 200},  {"ring", 500, 10},
+    {"query", 1000, 20},  {"alarm", 1000, 10},  {"countdown", 1000, 10}, {"upload", 10000, 100},
+    {"night", 60000, 20},
+};
+#    define SIM_MS (600u * 1000u)
+#endif
+#define TASKS (sizeof(_Tasks) / sizeof(_Tasks[0]))
+
+static MultiTimer _Timers[TASKS];
+static uint32_t _Runs[TASKS];
+static uint64_t _MaxLateness[TASKS];   // 以滴答计
+
+static void task_callback(MultiTimer* timer, void* arg)
+{
+    intptr_t i = (intptr_t)arg;
+    // 回调前定时器已按周期重新装载，本次的到期时刻在当前 deadline 之前 1 + overrun 个周期
+    uint64_t due      = timer->deadline - (1 + timer->overrun) * timer->period;
+    uint64_t lateness = virtual_ticks() - due;
+    if (lateness > _MaxLateness[i]) _MaxLateness[i] = lateness;
+    _Runs[i]++;
+    advance(_Tasks[i].cost_us, RUN);
+}
+
+int main(void)
+{
+    multiTimerInstall(virtual_ticks);
+    lowpower_init();
+    for (intptr_t i = 0; i < (intptr_t)TASKS; i++)
+    {
+        multiTimerStartPeriodic(&_Timers[i], _Tasks[i].period_ms, task_callback, (void*)i);
+    }
+
+    uint32_t loops = 0;
+    while (_RealUs < (uint64_t)SIM_MS * 1000)
+    {
+        uint64_t yield_tick = virtual_ticks();
+        int ticks_to_next   = multiTimerYield();
+        advance(YIELD_US, RUN);
+        lowpower_idle(yield_tick, ticks_to_next);
+        loops++;
+
+        // 补偿后的滴答与真实时间一致，HAL 滴答同步
+        CHECK(platform_ticks == _RealUs / 1000);
+        CHECK(uwTick == (uint32_t)platform_ticks);
+        if (test_failures) break;
+    }
+
+    // 每个任务都按周期执行且延迟不超过唤醒耗时加一个滴答
+    uint32_t max_lateness = 0;
+    for (size_t i = 0; i < TASKS; i++)
+    {
+        CHECK(_Runs[i] + _Timers[i].missed >= SIM_MS / _Tasks[i].period_ms - 1);
+        CHECK(_Timers[i].missed == 0);
+        if (_MaxLateness[i] > max_lateness) max_lateness = (uint32_t)_MaxLateness[i];
+    }
+    CHECK(max_lateness <= (WAKE_US + 999) / 1000 + 1);
+#if LOWPOWER_USE_STOP
+    CHECK(_StopEntries > 0);
+#else
+    CHECK(_StopEntries == 0);
+#endif
+
+    double total = (double)_RealUs;
+    double ma    = (RUN_MA * _ModeUs[RUN] + SLEEP_MA * _ModeUs[SLEEP] + STOP_MA * _ModeUs[STOP]) / total;
+    printf("%u s simulated, %u loops, %u STOP entries, max lateness %u ms\n", SIM_MS / 1000, loops, _StopEntries,
+           max_lateness);
+    printf("run %.2f%%, sleep %.2f%%, stop %.2f%%: estimated %.2f mA vs %.1f mA busy-waiting\n",
+           100.0 * _ModeUs[RUN] / total, 100.0 * _ModeUs[SLEEP] / total, 100.0 * _ModeUs[STOP] / total, ma, RUN_MA);
+    return test_result(LOWPOWER_USE_STOP ? "test_lowpower_stop" : "test_lowpower_sleep");
+}
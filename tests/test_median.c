@@ -0,0 +1,171 @@
+// 滑动中位数：与复制窗口后 qsort 的参考实现逐样本比较，并对比两者（及 9 输入排序网络）的每样本开销
+#include "median.h"
+#include "test_common.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_WINDOW 301
+#define CHECK_SAMPLES 20000
+#define BENCH_SAMPLES 50000
+
+/* ---------- 参考实现：原 Get_Filtered_Temperature 的复制 + qsort ---------- */
+
+static int compare_u16(const void* a, const void* b)
+{
+    return (int)*(const uint16_t*)a - (int)*(const uint16_t*)b;
+}
+
+static uint16_t qsort_median(const uint16_t* window, uint16_t count, uint16_t* scratch)
+{
+    memcpy(scratch, window, count * sizeof(uint16_t));
+    qsort(scratch, count, sizeof(uint16_t), compare_u16);
+    return scratch[count / 2];
+}
+
+/* ---------- 9 输入排序网络（19 次比较交换，只求中位数） ---------- */
+
+static inline void sort2(uint16_t* a, uint16_t* b)
+{
+    if (*a > *b)
+    {
+        uint16_t t = *a;
+        *a         = *b;
+        *b         = t;
+    }
+}
+
+static uint16_t network_median9(const uint16_t* window)
+{
+    uint16_t p[9];
+    memcpy(p, window, sizeof(p));
+    sort2(&p[1], &p[2]);
+    sort2(&p[4], &p[5]);
+    sort2(&p[7], &p[8]);
+    sort2(&p[0], &p[1]);
+    sort2(&p[3], &p[4]);
+    sort2(&p[6], &p[7]);
+    sort2(&p[1], &p[2]);
+    sort2(&p[4], &p[5]);
+    sort2(&p[7], &p[8]);
+    sort2(&p[0], &p[3]);
+    sort2(&p[5], &p[8]);
+    sort2(&p[4], &p[7]);
+    sort2(&p[3], &p[6]);
+    sort2(&p[1], &p[4]);
+    sort2(&p[2], &p[5]);
+    sort2(&p[4], &p[7]);
+    sort2(&p[4], &p[2]);
+    sort2(&p[6], &p[4]);
+    sort2(&p[4], &p[2]);
+    return p[4];
+}
+
+/* ---------- 正确性 ---------- */
+
+static uint16_t _Window[MAX_WINDOW];
+static uint16_t _Sorted[MAX_WINDOW];
+static uint16_t _History[MAX_WINDOW];   // 参考实现的窗口，按到达顺序
+static uint16_t _Scratch[MAX_WINDOW];
+
+// 少量取值的样本大量重复，检验相等元素的移位；偶尔跳变到量程两端
+static uint16_t random_sample(void)
+{
+    switch (rand() % 20)
+    {
+        case 0: return 0;
+        case 1: return 4095;
+        default: return 2000 + rand() % 16;
+    }
+}
+
+static void test_equivalence(uint16_t size)
+{
+    MedianFilter filter;
+    median_init(&filter, _Window, _Sorted, size);
+    CHECK(median_get(&filter) == 0);
+
+    uint32_t pushed = 0;
+    for (uint32_t i = 0; i < CHECK_SAMPLES; i++)
+    {
+        uint16_t sample = random_sample();
+        median_push(&filter, sample);
+        _History[pushed++ % size] = sample;
+
+        uint16_t count = pushed < size ? (uint16_t)pushed : size;
+        CHECK(filter.count == count);
+        CHECK(median_get(&filter) == qsort_median(_History, count, _Scratch));
+        CHECK(memcmp(filter.sorted, _Scratch, count * sizeof(uint16_t)) == 0);   // 整个有序窗口一致
+        if (test_failures) return;
+    }
+}
+
+/* ---------- 基准：每个新样本的开销（入队并读取中位数） ---------- */
+
+static uint16_t _Samples[BENCH_SAMPLES];
+
+static void bench(uint16_t size)
+{
+    MedianFilter filter;
+    uint32_t checksum = 0;
+
+    median_init(&filter, _Window, _Sorted, size);
+    double start = test_now_ns();
+    for (uint32_t i = 0; i < BENCH_SAMPLES; i++)
+    {
+        median_push(&filter, _Samples[i]);
+        checksum += median_get(&filter);
+    }
+    double stream_ns = (test_now_ns() - start) / BENCH_SAMPLES;
+
+    uint32_t reference = 0;
+    uint16_t head      = 0;
+    memset(_History, 0, sizeof(_History));
+    start = test_now_ns();
+    for (uint32_t i = 0; i < BENCH_SAMPLES; i++)
+    {
+        _History[head] = _Samples[i];
+        head           = (head + 1) % size;
+        uint16_t count = i + 1 < size ? (uint16_t)(i + 1) : size;
+        reference += qsort_median(_History, count, _Scratch);
+    }
+    double qsort_ns = (test_now_ns() - start) / BENCH_SAMPLES;
+    CHECK(checksum == reference);
+
+    printf("window %3u: streaming %6.1f ns/sample, copy + qsort %8.1f ns/sample", size, stream_ns, qsort_ns);
+    if (size == 9)
+    {
+        // 窗口满之后才有 9 个样本，从第 9 个样本开始比较
+        uint32_t network = 0, streaming = 0;
+        median_init(&filter, _Window, _Sorted, size);
+        for (uint32_t i = 0; i < 8; i++) median_push(&filter, _Samples[i]);
+        start = test_now_ns();
+        for (uint32_t i = 8; i < BENCH_SAMPLES; i++) network += network_median9(&_Samples[i - 8]);
+        double network_ns = (test_now_ns() - start) / (BENCH_SAMPLES - 8);
+        for (uint32_t i = 8; i < BENCH_SAMPLES; i++)
+        {
+            median_push(&filter, _Samples[i]);
+            streaming += median_get(&filter);
+        }
+        CHECK(network == streaming);
+        printf(", sorting network %5.1f ns/sample", network_ns);
+    }
+    printf("\n");
+}
+
+int main(void)
+{
+    static const uint16_t sizes[] = {1, 2, 3, 8, 9, 10, 31, 64, 101, 256, MAX_WINDOW};
+
+    srand(1);
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) test_equivalence(sizes[i]);
+    printf("equivalence: %u windows x %u samples match copy + qsort\n", (unsigned)(sizeof(sizes) / sizeof(sizes[0])),
+           CHECK_SAMPLES);
+
+    // 与 ntc.c 中抽取值相近的分布：缓慢漂移加噪声
+    for (uint32_t i = 0; i < BENCH_SAMPLES; i++) _Samples[i] = (uint16_t)(2000 + (i / 1000) % 200 + rand() % 32);
+    bench(9);
+    bench(31);
+    bench(101);
+    bench(MAX_WINDOW);
+    return test_result("test_median");
+}
@@ -0,0 +1,280 @@
+// MultiTimer 时间轮：随机启动/停止/重启的到期正确性、周期定时器的相位保持与错过计数，以及与原有序链表实现的调度开销对比
+#include "MultiTimer.h"
+#include "test_common.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define TIMERS 200
+#define BENCH_TICKS 100000
+
+static uint64_t _Now       = 0;   // 虚拟时钟
+static uint64_t _LastYield = 0;   // 上一次 multiTimerYield 的时刻
+static int _LastNext       = 0;   // 上一次 multiTimerYield 的返回值
+
+static uint64_t virtual_ticks(void)
+{
+    return _Now;
+}
+
+/* ---------- 正确性 ---------- */
+
+static MultiTimer _Timers[TIMERS];
+static uint64_t _Deadline[TIMERS];
+static uint64_t _StartedAt[TIMERS];
+static uint32_t _Fired = 0;
+
+static uint64_t random_timing(void)
+{
+    switch (rand() % 50)
+    {
+        case 0: return 40000000ull + rand() % 1000;   // 超出轮子跨度，进入溢出链表
+        case 1: return 0;
+        default: return rand() % 50000;
+    }
+}
+
+static void check_callback(MultiTimer* timer, void* arg);
+
+static void start_timer(int i)
+{
+    _StartedAt[i] = _Now;
+    _Deadline[i]  = _Now + random_timing();
+    multiTimerStart(&_Timers[i], _Deadline[i] - _Now, check_callback, (void*)(intptr_t)i);
+}
+
+static void check_callback(MultiTimer* timer, void* arg)
+{
+    int i = (int)(intptr_t)arg;
+    CHECK(_Now >= _Deadline[i]);   // 不提前
+    // 在到期后的第一次 yield 中执行，且上一次 yield 返回的等待时间是下界；
+    // 回调中启动的已到期定时器在本次或下一次 yield 中执行，不在此列
+    if (_StartedAt[i] != _LastYield && _StartedAt[i] != _Now)
+    {
+        CHECK(_LastYield < _Deadline[i]);
+        if (_LastNext > 0) CHECK(_Deadline[i] >= _LastYield + (uint64_t)_LastNext);
+    }
+    _Fired++;
+    start_timer(i);
+
+    int j = rand() % TIMERS;   // 回调中重启或停止任意定时器
+    switch (rand() % 4)
+    {
+        case 0: start_timer(j); break;
+        case 1:
+            multiTimerStop(&_Timers[j]);
+            _Deadline[j] = UINT64_MAX;
+            break;
+        default: break;
+    }
+}
+
+static void test_expiry(void)
+{
+    srand(1);
+    for (int i = 0; i < TIMERS; i++) start_timer(i);
+
+    for (int step = 0; step < 1000000; step++)
+    {
+        // 已停止的定时器不时重新启动，保持足够多的活动定时器
+        if (step % 16 == 0)
+        {
+            int i = rand() % TIMERS;
+            if (_Deadline[i] == UINT64_MAX) start_timer(i);
+        }
+        _Now += (rand() % 10000 == 0) ? 1000000 : (uint64_t)(rand() % 300 + 1);
+        uint64_t yield_tick = _Now;
+        int next            = multiTimerYield();
+        _LastYield          = yield_tick;
+        _LastNext           = next;
+    }
+    // 到这里没有执行的定时器都应尚未到期
+    for (int i = 0; i < TIMERS; i++)
+    {
+        CHECK(_Deadline[i] == UINT64_MAX || _Deadline[i] > _Now);
+        multiTimerStop(&_Timers[i]);
+    }
+    CHECK(_Fired > 100000);
+    printf("expiry: %u callbacks checked\n", _Fired);
+}
+
+/* ---------- 周期定时器 ---------- */
+
+static uint64_t _PeriodicLast = 0;   // 上一次回调的时刻
+static uint32_t _PeriodicRuns = 0;
+static uint32_t _PeriodicTime = 0;   // 回调按 1 + overrun 累计的周期数
+
+static void periodic_callback(MultiTimer* timer, void* arg)
+{
+    _PeriodicLast = _Now;
+    _PeriodicRuns++;
+    _PeriodicTime += 1 + timer->overrun;
+}
+
+static void test_periodic(void)
+{
+    static MultiTimer timer;
+    const uint64_t period = 1000;
+    uint64_t start        = _Now;
+
+    multiTimerStartPeriodic(&timer, period, periodic_callback, NULL);
+    srand(2);
+    for (int step = 0; step < 200000; step++)
+    {
+        // 大多数时候按小步推进，偶尔一次跳过多个周期
+        _Now += (rand() % 1000 == 0) ? (uint64_t)(rand() % 5000) : (uint64_t)(rand() % 50 + 1);
+        uint32_t runs = _PeriodicRuns;
+        multiTimerYield();
+        if (_PeriodicRuns != runs)
+        {
+            CHECK(_PeriodicRuns == runs + 1);                           // 错过的周期不补执行
+            CHECK((_PeriodicLast - start) / period == _PeriodicTime);   // 保持原相位，累计时间跟上实际时间
+        }
+    }
+    CHECK(timer.missed == _PeriodicTime - _PeriodicRuns);
+    CHECK(timer.missed > 0);
+    multiTimerStop(&timer);
+    printf("periodic: %u callbacks, %u periods skipped\n", _PeriodicRuns, timer.missed);
+}
+
+/* ---------- 基准：原 MultiTimer 的有序链表（启动时两次遍历） ---------- */
+
+typedef struct ListTimer
+{
+    struct ListTimer* next;
+    uint64_t deadline;
+    uint64_t period;
+} ListTimer;
+
+static ListTimer* _List = NULL;
+
+static void list_remove(ListTimer* timer)
+{
+    ListTimer** current = &_List;
+    while (*current)
+    {
+        if (*current == timer)
+        {
+            *current = timer->next;
+            break;
+        }
+        current = &(*current)->next;
+    }
+}
+
+static void list_start(ListTimer* timer, uint64_t timing)
+{
+    list_remove(timer);
+    timer->deadline      = _Now + timing;
+    ListTimer** current = &_List;
+    while (*current && (*current)->deadline < timer->deadline) current = &(*current)->next;
+    timer->next = *current;
+    *current    = timer;
+}
+
+static uint32_t list_yield(void)
+{
+    uint32_t dispatched = 0;
+    while (_List && _Now >= _List->deadline)
+    {
+        ListTimer* timer = _List;
+        _List            = timer->next;
+        list_start(timer, timer->period);   // 与原任务一样在回调中重启
+        dispatched++;
+    }
+    return dispatched;
+}
+
+/* ---------- 基准：时间轮 ---------- */
+
+static MultiTimer _BenchTimers[1000];
+static uint64_t _BenchPeriod[1000];
+static uint32_t _BenchDispatched = 0;
+
+static void bench_callback(MultiTimer* timer, void* arg)
+{
+    multiTimerStart(timer, _BenchPeriod[(intptr_t)arg], bench_callback, arg);
+    _BenchDispatched++;
+}
+
+static void bench(int count)
+{
+    static ListTimer list_timers[1000];
+
+    srand(count);
+    for (int i = 0; i < count; i++) _BenchPeriod[i] = 1 + rand() % 1000;
+
+    // 时间轮
+    for (int i = 0; i < count; i++)
+    {
+        multiTimerStart(&_BenchTimers[i], _BenchPeriod[i], bench_callback, (void*)(intptr_t)i);
+    }
+    _BenchDispatched = 0;
+    double start     = test_now_ns();
+    for (int t = 0; t < BENCH_TICKS; t++)
+    {
+        _Now++;
+        multiTimerYield();
+    }
+    double wheel_ns     = (test_now_ns() - start) / _BenchDispatched;
+    uint32_t wheel_runs = _BenchDispatched;
+    for (int i = 0; i < count; i++) multiTimerStop(&_BenchTimers[i]);
+
+    // 有序链表
+    _List = NULL;
+    for (int i = 0; i < count; i++)
+    {
+        list_timers[i].period = _BenchPeriod[i];
+        list_start(&list_timers[i], _BenchPeriod[i]);
+    }
+    uint32_t list_runs = 0;
+    start              = test_now_ns();
+    for (int t = 0; t < BENCH_TICKS; t++)
+    {
+        _Now++;
+        list_runs += list_yield();
+    }
+    double list_ns = (test_now_ns() - start) / list_runs;
+
+    CHECK(wheel_runs == list_runs);   // 两种实现的到期次数相同
+    printf("%5d timers: wheel %7.1f ns/dispatch, sorted list %8.1f ns/dispatch (%u dispatches)\n", count, wheel_ns,
+           list_ns, wheel_runs);
+}
+
+/* ---------- 统计寄存器 ---------- */
+
+static void count_callback(MultiTimer* timer, void* arg) {}
+
+static void test_stats_register(void)
+{
+    static MultiTimer timers[2];
+    static MultiTimer* const table[2] = {&timers[0], &timers[1]};
+
+    memset(timers, 0, sizeof(timers));
+    multiTimerStatsTable(table, 2, 72000);
+    multiTimerStartPeriodic(&timers[1], 10, count_callback, NULL);
+    for (int i = 0; i < 100; i++)
+    {
+        _Now += (i == 50) ? 35 : 1;   // 一次晚到 25 个滴答：跳过两个周期
+        multiTimerYield();
+    }
+    uint16_t base = MULTITIMER_STATS_REGISTERS;
+    CHECK(multiTimerStatsRegister(0) == 0);
+    CHECK(multiTimerStatsRegister(base + 0) == 0);                             // 调用次数高位
+    CHECK(multiTimerStatsRegister(base + 1) == timers[1].stats.invocations);   // 调用次数低位
+    CHECK(multiTimerStatsRegister(base + 6) == timers[1].stats.maxLateness);
+    CHECK(multiTimerStatsRegister(base + 7) == 2);
+    CHECK(multiTimerStatsRegister(2 * base) == 0);   // 超出任务表
+    multiTimerStop(&timers[1]);
+}
+
+int main(void)
+{
+    multiTimerInstall(virtual_ticks);
+    test_expiry();
+    test_periodic();
+    test_stats_register();
+    bench(10);
+    bench(100);
+    bench(1000);
+    return test_result("test_multitimer");
+}
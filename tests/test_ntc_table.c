@@ -0,0 +1,119 @@
+// NTC 查表：在整个 ADC 范围内与按 B 值公式用 log() 计算的温度比较，并与原来的浮点公式比较转换耗时
+#include "ntc_table.h"
+#include "test_common.h"
+#include <math.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+#define MAX_ERROR_C 0.01   // 1℃ 间隔线性插值与 Q8.8 量化的允许误差
+#define BENCH_CODES 4096
+#define BENCH_ROUNDS 2000
+
+// 参考：由分压比反推 NTC 阻值，再按 B 值公式求温度
+static double reference_celsius(uint16_t adc)
+{
+    double r = NTC_R_SERIES * adc / (4095.0 - adc);
+    return 1.0 / (1.0 / (25.0 + 273.15) + log(r / NTC_R25) / NTC_B) - 273.15;
+}
+
+// 原 NTC_temperature() 的浮点公式（单精度，含范围检查）
+static float formula_celsius(uint16_t adc_value)
+{
+    float B     = 3950.0f;
+    float R2    = 10000.0f;
+    float T2    = 25.0f;
+    float ntc_R = (adc_value / (4095.0f - adc_value)) * 10000.0f;
+
+    if (ntc_R == 0) return 0.0f;
+
+    float T1 = 1.0f / ((log(ntc_R / R2) / B) + (1.0f / (T2 + 273.15f))) - 273.15f;
+    if (T1 < -20.0f || T1 > 100.0f) return -100.0f;
+    return T1;
+}
+
+static void test_accuracy(void)
+{
+    double max_error   = 0.0;
+    uint16_t worst_adc = 0;
+    int valid          = 0;
+    int16_t previous   = INT16_MAX;
+
+    for (uint32_t adc = 0; adc <= 4095; adc++)
+    {
+        int16_t q88 = ntc_adc_to_q88((uint16_t)adc);
+        if (adc == 0 || adc == 4095)
+        {
+            CHECK(q88 == NTC_Q88_INVALID);   // 短路、开路
+            continue;
+        }
+
+        double expected = reference_celsius((uint16_t)adc);
+        if (q88 == NTC_Q88_INVALID)
+        {
+            // 只允许在表范围之外（边界上留 0.05℃ 的舍入余量）
+            CHECK(expected < NTC_T_MIN + 0.05 || expected > NTC_T_MIN + (NTC_TABLE_SIZE - 1) * NTC_T_STEP - 0.05);
+            continue;
+        }
+
+        double error = fabs(q88 / 256.0 - expected);
+        if (error > max_error)
+        {
+            max_error = error;
+            worst_adc = (uint16_t)adc;
+        }
+        CHECK(q88 <= previous);   // ADC 增大温度单调不增
+        previous = q88;
+        valid++;
+    }
+
+    CHECK(max_error < MAX_ERROR_C);
+    CHECK(valid > 3400);   // 表覆盖约 267..3740
+    printf("%d ADC codes in range, max error %.4f C at ADC %u (%.2f C)\n", valid, max_error, worst_adc,
+           reference_celsius(worst_adc));
+}
+
+// codes 中每个码值转换一次的平均耗时(ns)，table 为 false 时用原浮点公式
+static double time_conversions(const uint16_t* codes, bool table)
+{
+    volatile int32_t sink = 0;
+    double start          = test_now_ns();
+    for (int round = 0; round < BENCH_ROUNDS; round++)
+    {
+        for (int i = 0; i < BENCH_CODES; i++)
+        {
+            sink += table ? ntc_adc_to_q88(codes[i]) : (int32_t)formula_celsius(codes[i]);
+        }
+    }
+    (void)sink;
+    return (test_now_ns() - start) / ((double)BENCH_CODES * BENCH_ROUNDS);
+}
+
+/*
+ * 转换耗时：实际采样中温度缓慢变化，相邻码值接近（ramp）；
+ * 随机码值（random）使二分查找的分支无法预测，是主机上的最坏情况。
+ * 主机有硬件浮点，log() 远比 Cortex-M3 上软件模拟的快，结果只说明查表本身的开销；
+ * 目标板上的差别看控温任务的任务统计寄存器（最长执行时间）。
+ */
+static void bench(void)
+{
+    static uint16_t ramp[BENCH_CODES];
+    static uint16_t random_codes[BENCH_CODES];
+    srand(1);
+    for (int i = 0; i < BENCH_CODES; i++)
+    {
+        ramp[i]         = 267 + (uint32_t)i * (3740 - 267) / BENCH_CODES;
+        random_codes[i] = 267 + rand() % (3740 - 267 + 1);
+    }
+
+    printf("conversion (host, hardware FPU): ramp table %.1f ns, formula %.1f ns; ", time_conversions(ramp, true),
+           time_conversions(ramp, false));
+    printf("random table %.1f ns, formula %.1f ns\n", time_conversions(random_codes, true),
+           time_conversions(random_codes, false));
+}
+
+int main(void)
+{
+    test_accuracy();
+    bench();
+    return test_result("test_ntc_table");
+}
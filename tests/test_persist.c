@@ -0,0 +1,113 @@
+// 延迟写入：在虚拟时钟上运行真实的 persist.c 与 MultiTimer.c，检查突发修改的合并、最长推迟时间与同步写入
+#include "MultiTimer.h"
+#include "autotune.h"
+#include "persist.h"
+#include "test_common.h"
+
+static uint64_t _Now = 0;   // 虚拟时钟，单位 ms，HAL_GetTick 与 MultiTimer 共用
+
+static uint32_t _Saves[PERSIST_COUNT];
+static uint64_t _LastSave[PERSIST_COUNT];
+
+static uint64_t virtual_ticks(void)
+{
+    return _Now;
+}
+
+uint32_t HAL_GetTick(void)
+{
+    return (uint32_t)_Now;
+}
+
+void save_alarms(void)
+{
+    _Saves[PERSIST_ALARMS]++;
+    _LastSave[PERSIST_ALARMS] = _Now;
+}
+
+void save_config(void)
+{
+    _Saves[PERSIST_CONFIG]++;
+    _LastSave[PERSIST_CONFIG] = _Now;
+}
+
+void autotune_save(void)
+{
+    _Saves[PERSIST_TUNING]++;
+    _LastSave[PERSIST_TUNING] = _Now;
+}
+
+// 推进 ms 毫秒，每毫秒运行一次调度
+static void run_for(uint32_t ms)
+{
+    for (uint32_t i = 0; i < ms; i++)
+    {
+        _Now++;
+        multiTimerYield();
+    }
+}
+
+// APP 连续重发整个闹钟表：300ms 内每 30ms 修改一次，只保存一次，且在最后一次修改后 PERSIST_DELAY_MS 写入
+static void test_burst(void)
+{
+    uint32_t saves = _Saves[PERSIST_ALARMS];
+    uint64_t last  = 0;
+    for (int i = 0; i < 10; i++)
+    {
+        persist_mark(PERSIST_ALARMS);
+        last = _Now;
+        run_for(30);
+    }
+    CHECK(_Saves[PERSIST_ALARMS] == saves);
+    run_for(PERSIST_DELAY_MS);
+    CHECK(_Saves[PERSIST_ALARMS] == saves + 1);
+    CHECK(_LastSave[PERSIST_ALARMS] == last + PERSIST_DELAY_MS);
+    CHECK(_Saves[PERSIST_CONFIG] == 0);   // 未修改的数据集不写入
+    CHECK(_Saves[PERSIST_TUNING] == 0);
+    printf("burst: 10 marks in 300 ms, %u save\n", _Saves[PERSIST_ALARMS] - saves);
+}
+
+// 持续修改：第一次修改后 PERSIST_MAX_DELAY_MS 必须写入一次，停止修改后再写入一次
+static void test_max_delay(void)
+{
+    uint32_t saves = _Saves[PERSIST_CONFIG];
+    uint64_t first = _Now;
+    for (int i = 0; i < 40; i++)
+    {
+        persist_mark(PERSIST_CONFIG);
+        run_for(100);
+    }
+    CHECK(_Saves[PERSIST_CONFIG] == saves + 1);
+    CHECK(_LastSave[PERSIST_CONFIG] == first + PERSIST_MAX_DELAY_MS);
+    uint32_t capped = (uint32_t)(_LastSave[PERSIST_CONFIG] - first);
+    run_for(PERSIST_DELAY_MS);
+    CHECK(_Saves[PERSIST_CONFIG] == saves + 2);
+    printf("max delay: 4 s of marks, saved at +%u ms and again after the last mark\n", capped);
+}
+
+// 关机前同步写入，定时器随之停止，不会再写第二次
+static void test_flush(void)
+{
+    uint32_t alarms = _Saves[PERSIST_ALARMS];
+    uint32_t config = _Saves[PERSIST_CONFIG];
+    persist_mark(PERSIST_ALARMS);
+    persist_mark(PERSIST_CONFIG);
+    persist_flush();
+    CHECK(_Saves[PERSIST_ALARMS] == alarms + 1);
+    CHECK(_Saves[PERSIST_CONFIG] == config + 1);
+    run_for(PERSIST_MAX_DELAY_MS);
+    CHECK(_Saves[PERSIST_ALARMS] == alarms + 1);
+    CHECK(_Saves[PERSIST_CONFIG] == config + 1);
+
+    persist_flush();   // 没有待保存的数据集
+    CHECK(_Saves[PERSIST_ALARMS] == alarms + 1);
+}
+
+int main(void)
+{
+    multiTimerInstall(virtual_ticks);
+    test_burst();
+    test_max_delay();
+    test_flush();
+    return test_result("test_persist");
+}
@@ -0,0 +1,216 @@
+// 定点 PID：随机输入下每一步与同一算法的双精度实现逐位比较输出，并比较阶跃响应（各自驱动一个一阶加热对象）
+#include "pid.h"
+#include "test_common.h"
+#include <math.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+#define DT_MS 1000
+#define SIM_S 1800
+#define AMBIENT_C 25.0
+#define SETPOINT_C 45.0
+#define PLANT_GAIN 0.5    // 稳态温升（℃/%）
+#define PLANT_TAU 120.0   // 时间常数（s）
+#define PLANT_DEAD 10     // 纯滞后（采样周期数）
+#define DISTURB_S 1200    // 此时环境温度下降 5℃，检验积分项消除静差
+
+// 与 ntc.c 中的默认参数相同
+#define KP 10.0
+#define KI 0.1
+#define KD 4.5
+#define MAX_INTEGRAL 50.0
+
+#define RANDOM_RUNS 2000
+#define RANDOM_STEPS 600
+#define TIE_EPS 0.01   // 定点截断误差的上限（输出单位），参考输出的小数部分与 0.5 相差小于此值时视为舍入临界
+
+typedef struct
+{
+    double kp, ki, kd, max_integral;
+    double integral;
+    double prev_input;
+    int first_run;
+} FloatPid;
+
+static void float_pid_init(FloatPid* pid, double kp, double ki, double kd, double max_integral)
+{
+    *pid = (FloatPid){kp, ki, kd, max_integral, 0, 0, 1};
+}
+
+// 与 pid.c 相同的结构：积分分离、积分限幅、对测量值求导、输出限幅，返回舍入前的输出
+static double float_pid_raw(FloatPid* pid, double input, double setpoint, double dt)
+{
+    double error = setpoint - input;
+    double p     = pid->kp * error;
+
+    if (fabs(error) < PID_INTEGRAL_BAND_Q88 / 256.0)
+    {
+        pid->integral += pid->ki * error * dt;
+        if (pid->integral > pid->max_integral) pid->integral = pid->max_integral;
+        if (pid->integral < -pid->max_integral) pid->integral = -pid->max_integral;
+    } else
+    {
+        pid->integral = 0;
+    }
+
+    double d = 0;
+    if (!pid->first_run)
+        d = -pid->kd * (input - pid->prev_input) / dt;
+    else
+        pid->first_run = 0;
+    pid->prev_input = input;
+
+    double output = p + pid->integral + d;
+    if (output < 0) output = 0;
+    if (output > 100) output = 100;
+    return output;
+}
+
+static uint16_t float_pid(FloatPid* pid, double input, double setpoint, double dt)
+{
+    return (uint16_t)(float_pid_raw(pid, input, setpoint, dt) + 0.5);
+}
+
+/* ---------- 逐位比较 ---------- */
+
+// 随机增益、采样周期与温度序列；两者每步输入相同的 Q8.8 温度，参考实现使用与定点相同的增益值
+static void test_bit_accuracy(void)
+{
+    static const double gains[][3] = {
+        {KP, KI, KD},        // ntc.c 的默认参数
+        {25.0, 0.5, 0},      // 强比例、无微分
+        {3.0, 0.02, 40.0},   // 弱比例、强微分
+    };
+    static const uint16_t periods[] = {1000, 987, 100, 1};
+    uint32_t steps = 0, ties = 0, mismatches = 0;
+
+    srand(3);
+    for (int run = 0; run < RANDOM_RUNS; run++)
+    {
+        const double* g = gains[run % 3];
+        uint16_t dt_ms  = periods[rand() % 4];
+        int32_t kp = PID_Q16(g[0]), ki = PID_Q16(g[1]), kd = PID_Q16(g[2]), limit = PID_Q16(MAX_INTEGRAL);
+
+        PID_Controller fixed;
+        PID_Init(&fixed, kp, ki, kd, limit, PID_Q16(0.0f), PID_Q16(100.0f));
+        FloatPid reference;
+        float_pid_init(&reference, kp / 65536.0, ki / 65536.0, kd / 65536.0, limit / 65536.0);
+
+        int16_t setpoint = (int16_t)(256 * (30 + rand() % 31) + rand() % 256);
+        int32_t input    = setpoint + (rand() % 8001) - 4000;   // 起点在设定值 ±15.6℃ 内
+        for (int step = 0; step < RANDOM_STEPS; step++)
+        {
+            // 小幅随机游走，偶尔跳变到积分带之外
+            input += (rand() % 50 == 0) ? (rand() % 8001) - 4000 : (rand() % 129) - 64;
+            if (input < -20 * 256) input = -20 * 256;
+            if (input > 100 * 256) input = 100 * 256;
+
+            uint16_t out = PID(&fixed, (int16_t)input, setpoint, dt_ms);
+            double raw   = float_pid_raw(&reference, input / 256.0, setpoint / 256.0, dt_ms / 1000.0);
+            uint16_t ref = (uint16_t)(raw + 0.5);
+            steps++;
+            if (out == ref) continue;
+
+            bool tie = abs((int)out - (int)ref) == 1 && fabs(raw - floor(raw) - 0.5) < TIE_EPS;
+            if (tie)
+            {
+                ties++;
+            } else
+            {
+                mismatches++;
+                if (mismatches <= 5)
+                {
+                    fprintf(stderr, "run %d step %d: fixed %u, reference %.4f\n", run, step, out, raw);
+                }
+            }
+        }
+    }
+    CHECK(mismatches == 0);
+    printf("bit accuracy: %u steps, %u equal, %u differ by 1 at a rounding tie, %u other\n", steps,
+           steps - ties - mismatches, ties, mismatches);
+}
+
+/* ---------- 阶跃响应 ---------- */
+
+typedef struct
+{
+    double temp;
+    uint16_t delay[PLANT_DEAD];   // 尚未起作用的输出
+    int head;
+} Plant;
+
+static void plant_step(Plant* plant, uint16_t duty, double ambient)
+{
+    double dt     = DT_MS / 1000.0;
+    uint16_t late = plant->delay[plant->head];
+
+    plant->delay[plant->head] = duty;
+    plant->head               = (plant->head + 1) % PLANT_DEAD;
+    plant->temp += dt * (PLANT_GAIN * late - (plant->temp - ambient)) / PLANT_TAU;
+}
+
+// 两者都只看到 Q8.8 量化后的温度，与 ntc.c 一致
+static int16_t to_q88(double celsius)
+{
+    return (int16_t)lround(celsius * 256.0);
+}
+
+static void test_step_response(void)
+{
+    PID_Controller fixed;
+    PID_Init(&fixed, PID_Q16(KP), PID_Q16(KI), PID_Q16(KD), PID_Q16(MAX_INTEGRAL), PID_Q16(0.0f), PID_Q16(100.0f));
+    FloatPid reference;
+    float_pid_init(&reference, KP, KI, KD, MAX_INTEGRAL);
+
+    Plant fixed_plant = {AMBIENT_C}, float_plant = {AMBIENT_C};
+    double max_temp_diff = 0, peak_fixed = 0, peak_float = 0;
+    int max_duty_diff = 0, settled_fixed = -1, settled_float = -1;
+    int16_t setpoint_q88 = to_q88(SETPOINT_C);
+
+    for (int t = 0; t < SIM_S * 1000 / DT_MS; t++)
+    {
+        double ambient      = (t * DT_MS / 1000 < DISTURB_S) ? AMBIENT_C : AMBIENT_C - 5.0;
+        int16_t in_fixed    = to_q88(fixed_plant.temp);
+        int16_t in_float    = to_q88(float_plant.temp);
+        uint16_t duty_fixed = PID(&fixed, in_fixed, setpoint_q88, DT_MS);
+        uint16_t duty_float = float_pid(&reference, in_float / 256.0, setpoint_q88 / 256.0, DT_MS / 1000.0);
+
+        int duty_diff = abs((int)duty_fixed - (int)duty_float);
+        if (duty_diff > max_duty_diff) max_duty_diff = duty_diff;
+        double temp_diff = fabs(fixed_plant.temp - float_plant.temp);
+        if (temp_diff > max_temp_diff) max_temp_diff = temp_diff;
+
+        plant_step(&fixed_plant, duty_fixed, ambient);
+        plant_step(&float_plant, duty_float, ambient);
+        if (t * DT_MS / 1000 >= DISTURB_S) continue;
+
+        // 阶跃响应：峰值与最后一次进入 ±0.2℃ 的时刻
+        if (fixed_plant.temp > peak_fixed) peak_fixed = fixed_plant.temp;
+        if (float_plant.temp > peak_float) peak_float = float_plant.temp;
+        if (fabs(fixed_plant.temp - SETPOINT_C) > 0.2)
+            settled_fixed = -1;
+        else if (settled_fixed < 0)
+            settled_fixed = t;
+        if (fabs(float_plant.temp - SETPOINT_C) > 0.2)
+            settled_float = -1;
+        else if (settled_float < 0)
+            settled_float = t;
+    }
+
+    CHECK(max_temp_diff < 0.1);                          // 轨迹基本重合
+    CHECK(fabs(peak_fixed - peak_float) < 0.1);
+    CHECK(settled_fixed >= 0);                           // 定点实现收敛到设定值
+    CHECK(fabs(fixed_plant.temp - SETPOINT_C) < 0.05);   // 扰动后积分项消除静差
+    printf("fixed: overshoot %.2f C, settled at %d s; float: overshoot %.2f C, settled at %d s\n",
+           peak_fixed - SETPOINT_C, settled_fixed * DT_MS / 1000, peak_float - SETPOINT_C,
+           settled_float * DT_MS / 1000);
+    printf("after -5 C ambient step: fixed %.3f C, float %.3f C; max difference %.3f C, %d %% duty\n",
+           fixed_plant.temp, float_plant.temp, max_temp_diff, max_duty_diff);
+}
+
+int main(void)
+{
+    test_bit_accuracy();
+    test_step_response();
+    return test_result("test_pid");
+}
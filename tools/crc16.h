@@ -1,7 +1,23 @@
 #ifndef _CRC16_H
 #define _CRC16_H
 #include <stdint.h>
+
+/* 实现选择：字节表（默认，512B）、4字节切片（2KB，最快）、半字节表（32B，最省Flash） */
+#define CRC16_IMPL_TABLE 0
+#define CRC16_IMPL_SLICE4 1
+#define CRC16_IMPL_NIBBLE 2
+#ifndef CRC16_IMPL
+#    define CRC16_IMPL CRC16_IMPL_TABLE
+#endif
+
+#define CRC16_INIT 0xFFFF
+
+// 增量计算：crc = crc16_init()，随数据到达多次 crc16_update()，最后 crc16_final() 得到校验值
+uint16_t crc16_init(void);
+uint16_t crc16_update(uint16_t crc, const uint8_t* data, uint32_t len);
+uint16_t crc16_final(uint16_t crc);
+
 uint16_t _calc_check_value(const uint8_t data[], uint32_t dataLen);
 uint16_t _to_uint16(const uint8_t data[]);
 void _from_uint16(uint16_t value, uint8_t data[]);
-#endif /* _CRC16_H */
\ No newline at end of file
+#endif /* _CRC16_H */